@@ -1,8 +1,5 @@
 #version 460 core
-layout (location = 0) out vec3 gPosition;
-layout (location = 1) out vec3 gNormal;
-layout (location = 2) out vec4 gDiffuseShininess;
-layout (location = 3) out vec4 gAmbientSpecular;
+#include "gBufferWrite.glsl"
 
 in vec2 TexCoords;
 in vec3 FragPos;
@@ -11,6 +8,7 @@ in vec3 Normal;
 uniform sampler2D texture_diffuse1;
 uniform sampler2D texture_specular1;
 uniform vec2 texOffset;
+uniform int objectID;
 uniform mat3 textureMatrix;
 
 uniform bool useDiffTexture;
@@ -28,10 +26,6 @@ bool useTextures;
 void main()
 {
 
-    gPosition = FragPos;
-
-    gNormal = normalize(Normal);
-
     vec3 diffuse = material.diffuse.rgb;
     float shininess = material.shininess;
     vec3 specular = material.specular.rgb;
@@ -47,8 +41,6 @@ void main()
         specular += texture(texture_specular1, TexCoords+texOffset).rgb;
     }
 
-    gDiffuseShininess.rgb = diffuse;
-    gDiffuseShininess.a = shininess;
-    gAmbientSpecular.rgb = ambient;
-    gAmbientSpecular.a = specular.r;
+    writeObjectID(uint(objectID));
+    writeGBuffer(FragPos, Normal, diffuse, shininess, ambient, specular.r);
 }
\ No newline at end of file
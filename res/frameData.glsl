@@ -0,0 +1,16 @@
+// Constants of the whole frame, uploaded once per frame, the layout matches FrameData in src/renderers/FrameRing.h
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 inverseViewProjection;
+    vec4 viewPos;
+    vec4 sunDirection;
+    vec4 sunColor;
+    vec4 fogColor;
+    float fogDensity;
+    bool sunEnabled;
+    bool fogEnabled;
+};
@@ -0,0 +1,37 @@
+// G-buffer encodings shared by the geometry and lighting shaders
+
+// shininess is stored logarithmically in 8 bits
+#define SHININESS_MAX 2048.0
+
+// specular values up to 2 (material + texture) fit the 8-bit channel
+#define SPECULAR_SCALE 2.0
+
+// octahedral encoding of a unit normal into [-1, 1]^2
+vec2 octEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0) {
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return e;
+}
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+float packShininess(float shininess)
+{
+    return log2(clamp(shininess, 0.0, SHININESS_MAX) + 1.0) / log2(SHININESS_MAX + 1.0);
+}
+
+float unpackShininess(float encoded)
+{
+    return exp2(encoded * log2(SHININESS_MAX + 1.0)) - 1.0;
+}
@@ -0,0 +1,37 @@
+// G-buffer outputs, GBUFFER_FULL selects the uncompressed layout kept for comparison
+
+#include "gBufferPacking.glsl"
+
+#ifdef GBUFFER_FULL
+layout (location = 0) out vec3 gPosition;
+layout (location = 1) out vec3 gNormal;
+layout (location = 2) out vec4 gDiffuseShininess;
+layout (location = 3) out vec4 gAmbientSpecular;
+layout (location = 4) out uint gObjectID;
+#else
+// the position is reconstructed from the depth buffer
+layout (location = 0) out vec2 gNormal;
+layout (location = 1) out vec4 gDiffuseShininess;
+layout (location = 2) out vec4 gAmbientSpecular;
+layout (location = 3) out uint gObjectID;
+#endif
+
+void writeGBuffer(vec3 fragPos, vec3 normal, vec3 diffuse, float shininess, vec3 ambient, float specular)
+{
+#ifdef GBUFFER_FULL
+    gPosition = fragPos;
+    gNormal = normalize(normal);
+    gDiffuseShininess = vec4(diffuse, shininess);
+    gAmbientSpecular = vec4(ambient, specular);
+#else
+    gNormal = octEncode(normalize(normal));
+    gDiffuseShininess = vec4(diffuse, packShininess(shininess));
+    gAmbientSpecular = vec4(ambient, specular / SPECULAR_SCALE);
+#endif
+}
+
+// the ID read back for picking, 0 is the background
+void writeObjectID(uint id)
+{
+    gObjectID = id;
+}
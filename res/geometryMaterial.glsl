@@ -0,0 +1,22 @@
+// Material of the geometry pass, shared by the plain and the instanced shader
+
+#include "gBufferWrite.glsl"
+#include "materialData.glsl"
+
+void writeMaterial(vec3 fragPos, vec3 normal, vec2 texCoords)
+{
+    vec3 diffuse = material.diffuse.rgb;
+    float shininess = material.shininess;
+    vec3 specular = material.specular.rgb;
+    vec3 ambient = material.diffuse.rgb;
+
+    if(material.useDiffTexture){
+        diffuse = texture(texture_diffuse1, texCoords).rgb;
+        ambient *= texture(texture_diffuse1, texCoords).rgb;
+    }
+    if(material.useSpecTexture){
+        specular += texture(texture_specular1, texCoords).rgb;
+    }
+
+    writeGBuffer(fragPos, normal, diffuse, shininess, ambient, specular.r);
+}
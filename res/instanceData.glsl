@@ -0,0 +1,14 @@
+// Per-instance data of the instanced draws, the layout matches InstanceData in src/renderers/RenderQueue.h
+
+struct InstanceData
+{
+    mat4 model;
+    // the inverse transpose of the model matrix, computed once on the CPU
+    mat3x4 normalMatrix;
+    uint id;
+};
+
+layout(std430, binding = 4) readonly buffer Instances
+{
+    InstanceData instances[];
+};
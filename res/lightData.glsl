@@ -0,0 +1,20 @@
+// Light table shared by the shaders, the layout matches LightData in src/graphics/lighting/Lighting.h
+
+// narrower lights have a single perspective shadow map, the same value is defined in Lighting.h
+#define SPOT_SHADOW_MAX_ANGLE 120.0
+
+struct LightData
+{
+    vec3 position;
+    vec3 color;
+    vec3 attenuation;
+    float shadowTileSize;
+    vec4 direction_angle;
+    vec4 shadowTiles[3];
+    mat4 vp[6];
+};
+
+layout(std430, binding = 0) readonly buffer Lights
+{
+    LightData lightData[];
+};
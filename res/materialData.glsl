@@ -0,0 +1,14 @@
+// Parameters of the bound material, the layout matches MaterialData in src/graphics/models/MaterialRegistry.h
+
+layout(std140, binding = 1) uniform MaterialBlock
+{
+    vec4 diffuse;
+    vec4 specular;
+    float shininess;
+    bool useDiffTexture;
+    bool useSpecTexture;
+} material;
+
+// the texture units are fixed, MATERIAL_UNIT_DIFFUSE and MATERIAL_UNIT_SPECULAR
+layout(binding = 0) uniform sampler2D texture_diffuse1;
+layout(binding = 1) uniform sampler2D texture_specular1;
@@ -5,9 +5,9 @@ layout (location = 1) in vec3 aNormal;
 out vec3 FragPos;
 out vec3 Normal;
 
+#include "frameData.glsl"
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
@@ -17,5 +17,5 @@ void main()
     mat3 normalMatrix = transpose(inverse(mat3(model)));
     Normal = normalMatrix * aNormal;
 
-    gl_Position = projection * view * worldPos;
+    gl_Position = viewProjection * worldPos;
 }
\ No newline at end of file
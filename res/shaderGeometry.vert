@@ -7,9 +7,9 @@ out vec3 FragPos;
 out vec2 TexCoords;
 out vec3 Normal;
 
+#include "frameData.glsl"
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
@@ -20,5 +20,5 @@ void main()
     mat3 normalMatrix = transpose(inverse(mat3(model)));
     Normal = normalMatrix * aNormal;
 
-    gl_Position = projection * view * worldPos;
+    gl_Position = viewProjection * worldPos;
 }
\ No newline at end of file
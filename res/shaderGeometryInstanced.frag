@@ -0,0 +1,20 @@
+#version 460 core
+#ifdef GL_ARB_shader_stencil_export
+#extension GL_ARB_shader_stencil_export : enable
+#endif
+#include "geometryMaterial.glsl"
+
+in vec2 TexCoords;
+in vec3 FragPos;
+in vec3 Normal;
+flat in uint objectID;
+
+void main()
+{
+#ifdef GL_ARB_shader_stencil_export
+    // the stencil holds the ID of the instance, used for the outline
+    gl_FragStencilRefARB = int(objectID & 0xFFu);
+#endif
+    writeObjectID(objectID);
+    writeMaterial(FragPos, Normal, TexCoords);
+}
@@ -0,0 +1,26 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+#include "frameData.glsl"
+#include "instanceData.glsl"
+
+out vec3 FragPos;
+out vec2 TexCoords;
+out vec3 Normal;
+flat out uint objectID;
+
+void main()
+{
+    // the base instance of the indirect command is the first instance of the group
+    InstanceData instance = instances[gl_BaseInstance + gl_InstanceID];
+    vec4 worldPos = instance.model * vec4(aPos, 1.0);
+    FragPos = worldPos.xyz;
+    TexCoords = aTexCoords;
+    objectID = instance.id;
+
+    Normal = mat3(instance.normalMatrix) * aNormal;
+
+    gl_Position = viewProjection * worldPos;
+}
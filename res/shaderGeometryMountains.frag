@@ -1,26 +1,22 @@
 #version 460 core
-layout (location = 0) out vec3 gPosition;
-layout (location = 1) out vec3 gNormal;
-layout (location = 2) out vec4 gDiffuseShininess;
-layout (location = 3) out vec4 gAmbientSpecular;
+#ifdef GL_ARB_shader_stencil_export
+#extension GL_ARB_shader_stencil_export : enable
+#endif
+#include "gBufferWrite.glsl"
 
 in vec3 FragPos;
 in vec3 Normal;
+flat in uint objectID;
 
-struct Materials {
-    vec4 diffuse;
-    vec4 specular;
-    float shininess;
-};
-
-uniform Materials material;
+#include "materialData.glsl"
 
 void main()
 {
-    gPosition = FragPos;
-
-    gNormal = normalize(Normal);
-
+#ifdef GL_ARB_shader_stencil_export
+    // the stencil holds the ID of the instance, used for the outline
+    gl_FragStencilRefARB = int(objectID & 0xFFu);
+#endif
+    writeObjectID(objectID);
     vec3 diffuse = material.diffuse.rgb;
     float shininess = material.shininess;
     vec3 specular = material.specular.rgb;
@@ -31,8 +27,5 @@ void main()
         fragColor = vec4(1.0, 1.0, 1.0, 1.0);
     }
 
-    gDiffuseShininess.rgb = fragColor.rgb;
-    gDiffuseShininess.a = shininess;
-    gAmbientSpecular.rgb = fragColor.rgb;
-    gAmbientSpecular.a = specular.r;
+    writeGBuffer(FragPos, Normal, fragColor.rgb, shininess, fragColor.rgb, specular.r);
 }
\ No newline at end of file
@@ -2,20 +2,21 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
+#include "frameData.glsl"
+#include "instanceData.glsl"
+
 out vec3 FragPos;
 out vec3 Normal;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+flat out uint objectID;
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    InstanceData instance = instances[gl_BaseInstance + gl_InstanceID];
+    vec4 worldPos = instance.model * vec4(aPos, 1.0);
     FragPos = worldPos.xyz;
+    objectID = instance.id;
 
-    mat3 normalMatrix = transpose(inverse(mat3(model)));
-    Normal = normalMatrix * aNormal;
+    Normal = mat3(instance.normalMatrix) * aNormal;
 
-    gl_Position = projection * view * worldPos;
-}
\ No newline at end of file
+    gl_Position = viewProjection * worldPos;
+}
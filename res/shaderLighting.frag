@@ -3,63 +3,95 @@ out vec4 color;
 
 in vec2 texCoord;
 
+#include "gBufferPacking.glsl"
+
+#ifdef GBUFFER_FULL
 uniform sampler2D gPosition;
+#else
+// the position is reconstructed from the depth
+uniform sampler2D gDepth;
+#endif
 uniform sampler2D gNormal;
 uniform sampler2D gDiffuseShininess;
 uniform sampler2D gAmbientSpecular;
 
-uniform samplerCubeArray depthMap;
+uniform sampler2D shadowAtlas;
 
-struct Sun
-{
-    vec3 direction;
-    vec3 color;
-    bool enabled;
-};
+#include "frameData.glsl"
+#include "lightData.glsl"
 
-struct LightData
+// the same values are defined in src/graphics/lighting/LightClusters.h
+#define CLUSTERS_X 16
+#define CLUSTERS_Y 9
+#define CLUSTERS_Z 24
+
+// offset and count of the lights of every cluster
+layout(std430, binding = 1) readonly buffer ClusterGrid
 {
-    vec3 position;
-    vec3 color;
-    vec3 attenuation;
-    vec4 direction_angle;
-    mat4 vp[6];
+    uvec2 clusterRanges[];
 };
 
-struct Fog
+layout(std430, binding = 2) readonly buffer ClusterIndices
 {
-    vec3 color;
-    float density;
-    bool enabled;
+    uint clusterLights[];
 };
 
-layout(std140, binding = 0) uniform Light
-{
-    LightData lightData[10];
-} light_f;
+uniform vec2 screenSize;
 
-uniform vec3 viewPos;
+// the part of the G-buffer textures covered by the render resolution
+uniform vec2 uvScale;
 
-uniform int lightsCount;
+// scale and bias mapping log(depth) to the depth slice
+uniform vec2 clusterSlice;
 
-uniform Sun sun;
 
-uniform Fog fog;
+// the depth stored in the atlas tile of the cube face (or spot frustum) the fragment falls on
+float shadowAtlasDepth(int i, vec3 fragPos, vec3 lightToFrag)
+{
+    vec3 a = abs(lightToFrag);
+    int face;
+    if (lightData[i].direction_angle.a < SPOT_SHADOW_MAX_ANGLE) {
+        // a spot light has a single projective map
+        face = 0;
+    } else if (a.x >= a.y && a.x >= a.z) {
+        face = lightToFrag.x > 0 ? 0 : 1;
+    } else if (a.y >= a.z) {
+        face = lightToFrag.y > 0 ? 2 : 3;
+    } else {
+        face = lightToFrag.z > 0 ? 4 : 5;
+    }
+    vec4 clip = lightData[i].vp[face] * vec4(fragPos, 1.0);
+    vec4 tiles = lightData[i].shadowTiles[face / 2];
+    vec2 offset = (face % 2 == 0) ? tiles.xy : tiles.zw;
 
+    // keep the lookup inside the tile
+    float halfTexel = 0.5 / (lightData[i].shadowTileSize * textureSize(shadowAtlas, 0).x);
+    vec2 uv = clamp(clip.xy / clip.w * 0.5 + 0.5, halfTexel, 1.0 - halfTexel);
+    return texture(shadowAtlas, offset + uv * lightData[i].shadowTileSize).r;
+}
 
 void main()
 {
-    vec3 fragPos = texture(gPosition, texCoord).rgb;
-    vec3 N = texture(gNormal, texCoord).rgb;
-    vec3 kd = texture(gDiffuseShininess, texCoord).rgb;
-    float p = texture(gDiffuseShininess, texCoord).a;
-    vec3 ka = texture(gAmbientSpecular, texCoord).rgb;
+    vec2 uv = texCoord * uvScale;
+#ifdef GBUFFER_FULL
+    vec3 fragPos = texture(gPosition, uv).rgb;
+    vec3 N = texture(gNormal, uv).rgb;
+    float p = texture(gDiffuseShininess, uv).a;
+    float ks = texture(gAmbientSpecular, uv).a;
+#else
+    vec4 worldPos = inverseViewProjection * vec4(vec3(texCoord, texture(gDepth, uv).r) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = worldPos.xyz / worldPos.w;
+    vec3 N = octDecode(texture(gNormal, uv).rg);
+    float p = unpackShininess(texture(gDiffuseShininess, uv).a);
+    float ks = texture(gAmbientSpecular, uv).a * SPECULAR_SCALE;
+#endif
+    vec3 kd = texture(gDiffuseShininess, uv).rgb;
+    vec3 ka = texture(gAmbientSpecular, uv).rgb;
     ka = ka*0.2;
-    float ks = texture(gAmbientSpecular, texCoord).a;
 
 
     vec3 L_vertex;
-    vec3 Cam_vertex = normalize(viewPos - fragPos);
+    vec3 Cam_vertex = normalize(viewPos.xyz - fragPos);
     float diffuse;
     vec3 H;
     float specular;
@@ -74,64 +106,74 @@ void main()
     float cubemap_depth;
 
     color = vec4(ka, 1);
-    if (sun.enabled){
-        vec3 sunDir = normalize(-sun.direction);
+    if (sunEnabled){
+        vec3 sunDir = normalize(-sunDirection.xyz);
         diffuse = max(dot(sunDir, N), 0.0);
 
         H = normalize(sunDir + Cam_vertex);
         specular = pow(max(dot(H, N), 0.0), p);
 
-        color += vec4(sun.color*kd*diffuse, 1) + vec4(sun.color*ks*specular, 1);
+        color += vec4(sunColor.rgb*kd*diffuse, 1) + vec4(sunColor.rgb*ks*specular, 1);
     }
 
 
+    float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / screenSize * vec2(CLUSTERS_X, CLUSTERS_Y)),
+                       ivec2(0), ivec2(CLUSTERS_X - 1, CLUSTERS_Y - 1));
+    int slice = clamp(int(log(max(viewDepth, 1e-4)) * clusterSlice.x - clusterSlice.y), 0, CLUSTERS_Z - 1);
+    uvec2 range = clusterRanges[tile.x + CLUSTERS_X * (tile.y + CLUSTERS_Y * slice)];
+
     int i;
-    for (i = 0; i < lightsCount; i++)
+    for (uint c = 0; c < range.y; c++)
     {
+        i = int(clusterLights[range.x + c]);
         shadowValue = 0;
-        fragPosLightSpace = fragPos - light_f.lightData[i].position;
-        cubemap_depth = length(fragPosLightSpace) / light_f.lightData[i].attenuation.r;
-
-        pcfDepth = texture(depthMap, vec4(fragPosLightSpace, i)).r;
-        if (cubemap_depth - 0.15/light_f.lightData[i].attenuation.r > pcfDepth)
-        shadowValue = 1.0;
+        fragPosLightSpace = fragPos - lightData[i].position;
+        cubemap_depth = length(fragPosLightSpace) / lightData[i].attenuation.r;
+
+        // lights that did not fit the shadow atlas have no tiles
+        if (lightData[i].shadowTileSize > 0) {
+            pcfDepth = shadowAtlasDepth(i, fragPos, fragPosLightSpace);
+            if (cubemap_depth - 0.15/lightData[i].attenuation.r > pcfDepth)
+            shadowValue = 1.0;
+        }
 
 
-        L_vertex = light_f.lightData[i].position - fragPos;
+        L_vertex = lightData[i].position - fragPos;
 
         L_distance = length(L_vertex);
 
-        if (L_distance < light_f.lightData[i].attenuation.r)
+        if (L_distance < lightData[i].attenuation.r)
         {
             L_vertex = normalize(L_vertex);
-            acosA = degrees(acos(dot(-L_vertex, normalize(light_f.lightData[i].direction_angle.xyz))));
-            if (acosA <= light_f.lightData[i].direction_angle.a/2)
+            acosA = degrees(acos(dot(-L_vertex, normalize(lightData[i].direction_angle.xyz))));
+            if (acosA <= lightData[i].direction_angle.a/2)
             {
                 diffuse = max(dot(L_vertex, N), 0.0);
 
                 H = normalize(L_vertex + Cam_vertex);
                 specular = pow(max(dot(H, N), 0.0), p);
 
-                attenuation = 1 / (1 + light_f.lightData[i].attenuation[1] * L_distance + light_f.lightData[i].attenuation[2] * L_distance * L_distance);
+                attenuation = 1 / (1 + lightData[i].attenuation[1] * L_distance + lightData[i].attenuation[2] * L_distance * L_distance);
 
-                if (light_f.lightData[i].direction_angle.a/2 < 180)
+                if (lightData[i].direction_angle.a/2 < 180)
                 {
-                    intensity = clamp((light_f.lightData[i].direction_angle.a/2 - acosA) / 5, 0.0, 1.0);
+                    intensity = clamp((lightData[i].direction_angle.a/2 - acosA) / 5, 0.0, 1.0);
                     diffuse  *= intensity;
                     specular *= intensity;
                 }
 
-                vec3 diffColor = light_f.lightData[i].color*kd*diffuse;
-                vec3 specColor = light_f.lightData[i].color*ks*specular;
-                if (fog.enabled){
-                    float distance = length(viewPos - fragPos);
+                vec3 diffColor = lightData[i].color*kd*diffuse;
+                vec3 specColor = lightData[i].color*ks*specular;
+                if (fogEnabled){
+                    float distance = length(viewPos.xyz - fragPos);
 
-                    float fogFactor = 1.0 - exp(-fog.density * distance);
+                    float fogFactor = 1.0 - exp(-fogDensity * distance);
 
                     fogFactor = clamp(fogFactor, 0.0, 1.0);
 
-                    diffColor = mix(light_f.lightData[i].color*kd*diffuse, light_f.lightData[i].color, fogFactor);
-                    specColor = mix(light_f.lightData[i].color*ks*specular, light_f.lightData[i].color, fogFactor);
+                    diffColor = mix(lightData[i].color*kd*diffuse, lightData[i].color, fogFactor);
+                    specColor = mix(lightData[i].color*ks*specular, lightData[i].color, fogFactor);
                 }
 
                 color += (vec4(diffColor * attenuation, 1)
@@ -141,17 +183,17 @@ void main()
 
         }
     }
-    if(fog.enabled){
-        float distance = length(viewPos - fragPos);
+    if(fogEnabled){
+        float distance = length(viewPos.xyz - fragPos);
 
-        float fogFactor = 1.0 - exp(-fog.density/4 * distance);
+        float fogFactor = 1.0 - exp(-fogDensity/4 * distance);
 
         fogFactor = clamp(fogFactor, 0.0, 1.0);
-        vec3 fogColor = fog.color;
-        if(!sun.enabled){
-            fogColor = vec3(0.0);
+        vec3 fogTint = fogColor.rgb;
+        if(!sunEnabled){
+            fogTint = vec3(0.0);
         }
-        color = vec4(mix(color.rgb, fogColor, fogFactor), 1.0);
+        color = vec4(mix(color.rgb, fogTint, fogFactor), 1.0);
     }
 
 
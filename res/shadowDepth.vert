@@ -1,9 +1,43 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 model;
+#include "lightData.glsl"
+#include "instanceData.glsl"
+
+// the light of every instance, and its cube face (0 for a spot light) in the low 3 bits with the index of the
+// caster's instance data above
+layout(std430, binding = 3) readonly buffer ShadowPairs
+{
+    uvec2 shadowPairs[];
+};
+
+// the first pair of a draw not submitted by an indirect command, 0 otherwise
+uniform int pairOffset;
+
+out vec4 FragPos;
+out vec3 lightPos;
+out float radius;
 
 void main()
 {
-    gl_Position = model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    uvec2 pair = shadowPairs[pairOffset + gl_BaseInstance + gl_InstanceID];
+    int face = int(pair.y & 7u);
+
+    FragPos = instances[pair.y >> 3].model * vec4(aPos, 1.0);
+    lightPos = lightData[pair.x].position;
+    radius = lightData[pair.x].attenuation.r;
+    vec4 clip = lightData[pair.x].vp[face] * FragPos;
+
+    // the sides of the face frustum are the edges of the tile
+    gl_ClipDistance[0] = clip.w + clip.x;
+    gl_ClipDistance[1] = clip.w - clip.x;
+    gl_ClipDistance[2] = clip.w + clip.y;
+    gl_ClipDistance[3] = clip.w - clip.y;
+
+    // move the face from the whole atlas into its tile
+    vec4 tiles = lightData[pair.x].shadowTiles[face / 2];
+    vec2 offset = (face % 2 == 0) ? tiles.xy : tiles.zw;
+    float size = lightData[pair.x].shadowTileSize;
+    clip.xy = clip.xy * size + (2.0 * offset + size - 1.0) * clip.w;
+    gl_Position = clip;
+}
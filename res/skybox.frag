@@ -1,13 +1,11 @@
-#version 330 core
+#version 460 core
 out vec4 FragColor;
 
 in vec3 TexCoords;
 
-uniform samplerCube skybox;
+#include "frameData.glsl"
 
-uniform bool sunEnabled;
-uniform bool fogEnabled;
-uniform vec3 fogColor;
+uniform samplerCube skybox;
 
 void main()
 {
@@ -15,7 +13,7 @@ void main()
     vec3 finalColor = color.rgb;
     if(fogEnabled){
         float fogFactor = 0.95;
-        vec3 fColor = fogColor;
+        vec3 fColor = fogColor.rgb;
         if(!sunEnabled){
             fColor = vec3(0.0);
         }
@@ -24,4 +22,4 @@ void main()
     }
 
     FragColor = vec4(finalColor, color.a);
-}
\ No newline at end of file
+}
@@ -1,14 +1,14 @@
-#version 330 core
+#version 460 core
 layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
+#include "frameData.glsl"
 
 void main()
 {
     TexCoords = aPos;
-    vec4 pos = projection * view * vec4(aPos, 1.0);
+    // the rotation of the camera only, the skybox stays around it
+    vec4 pos = projection * mat4(mat3(view)) * vec4(aPos, 1.0);
     gl_Position = pos.xyww;
-}
\ No newline at end of file
+}
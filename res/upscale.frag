@@ -0,0 +1,15 @@
+#version 460 core
+out vec4 color;
+
+in vec2 texCoord;
+
+uniform sampler2D image;
+
+// the part of the image covered by the render resolution, and its last texel center
+uniform vec2 uvScale;
+uniform vec2 maxUV;
+
+void main()
+{
+    color = vec4(texture(image, min(texCoord * uvScale, maxUV)).rgb, 1.0);
+}
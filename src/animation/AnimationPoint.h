@@ -26,6 +26,10 @@ public:
     /// @param ID The unique identifier for the animation point. Default is 0.
     /// @param copy A flag indicating whether the animation point is a copy. Default is false.
     AnimationPoint(std::string const &path = "res/animation/animation_point.obj", size_t ID = 0, bool copy = false);
+
+    /// @brief Checks whether the animation point is skipped by the geometry pass.
+    /// @return The value of the hide flag.
+    bool hidden() const override { return hide; }
 };
 
 #endif //PROJECT_ANIMATIONPOINT_H
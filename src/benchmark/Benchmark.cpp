@@ -0,0 +1,82 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "Benchmark.h"
+#include "../scene/Scene.h"
+#include "../window/InputTrace.h"
+
+Benchmark::Benchmark(Scene &scene, size_t frames, float deltaTime, InputTrace *trace) : scene_(scene),
+                                                                                        frames_(frames),
+                                                                                        deltaTime_(deltaTime),
+                                                                                        trace_(trace) {}
+
+void Benchmark::run() {
+    size_t frames = 0;
+    double total = 0.0;
+    double frameMax = 0.0;
+    double passTotals[PASS_COUNT] = {};
+    double passMax[PASS_COUNT] = {};
+    double scaleTotal = 0.0;
+
+    PassTimer &passTimer = scene_.renderer.passTimer;
+    double gpuStart[PASS_COUNT];
+    std::copy(passTimer.gpuTotals, passTimer.gpuTotals + PASS_COUNT, gpuStart);
+    size_t resolvedStart = passTimer.resolvedFrames;
+
+    passTimer.sync = true;
+    for (size_t frame = 0; frame < frames_; frame++) {
+        float deltaTime = deltaTime_;
+        if (trace_ != nullptr && !trace_->replay(deltaTime)) {
+            break;
+        }
+        auto start = std::chrono::steady_clock::now();
+        scene_.update(deltaTime);
+        scene_.draw();
+        auto end = std::chrono::steady_clock::now();
+
+        double frameTime = std::chrono::duration<double, std::milli>(end - start).count();
+        scene_.frameStats.record(frameTime / 1000.0);
+        frames++;
+        total += frameTime;
+        frameMax = std::max(frameMax, frameTime);
+        // the scale is updated before the frame is drawn, so this is the one the frame was rendered at
+        scaleTotal += scene_.renderer.resolution.scale;
+        for (int pass = 0; pass < PASS_COUNT; pass++) {
+            passTotals[pass] += passTimer.passTimes[pass];
+            passMax[pass] = std::max(passMax[pass], passTimer.passTimes[pass]);
+        }
+    }
+    passTimer.sync = false;
+    // the queries of the last frames are still in flight and are not counted
+    auto resolved = (double) (passTimer.resolvedFrames - resolvedStart);
+
+    if (frames == 0) {
+        std::printf("No frames rendered\n");
+        return;
+    }
+    auto count = (double) frames;
+
+    if (trace_ != nullptr) {
+        std::printf("\nBenchmark: %zu frames replayed from input trace\n", frames);
+    } else {
+        std::printf("\nBenchmark: %zu frames, dt %.4f s\n", frames, deltaTime_);
+    }
+    std::printf("%-12s %10s %10s %10s\n", "pass", "avg ms", "max ms", "gpu ms");
+    double gpuTotal = 0.0;
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        double gpuAverage = resolved > 0.0 ? (passTimer.gpuTotals[pass] - gpuStart[pass]) / resolved : 0.0;
+        gpuTotal += gpuAverage;
+        std::printf("%-12s %10.3f %10.3f %10.3f\n", RENDER_PASS_NAMES[pass], passTotals[pass] / count,
+                    passMax[pass], gpuAverage);
+    }
+    std::printf("%-12s %10.3f %10.3f %10.3f\n", "frame", total / count, frameMax, gpuTotal);
+    std::printf("avg fps %.1f\n", 1000.0 * count / total);
+    std::printf("resolution scale avg %.3f final %.3f (target %.2f ms)\n", scaleTotal / count,
+                scene_.renderer.resolution.scale, scene_.renderer.resolution.targetFrameTime);
+    scene_.frameStats.printSummary();
+}
@@ -0,0 +1,45 @@
+/// @file Benchmark.h
+/// @brief This file contains the definition of the Benchmark class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_BENCHMARK_H
+#define PROJECT_BENCHMARK_H
+
+#include <cstddef>
+
+class Scene;
+class InputTrace;
+
+/// @class Benchmark
+/// @brief The Benchmark class drives a scene for a fixed number of frames and reports frame timings.
+/// @details Every frame is updated with the same delta time, so runs of different builds are comparable.
+/// Per-pass timings are collected with the renderer's PassTimer and printed together with the total frame time.
+/// When an input trace is given, the frames and their delta times are taken from the trace instead.
+class Benchmark {
+public:
+    /// @brief Constructs a Benchmark object for the specified scene.
+    /// @param scene The scene to run.
+    /// @param frames The number of frames to render.
+    /// @param deltaTime The fixed time step passed to every update.
+    /// @param trace The input trace to replay, nullptr to run without input.
+    Benchmark(Scene &scene, size_t frames, float deltaTime, InputTrace *trace = nullptr);
+
+    /// @brief Runs the benchmark and prints the results to the standard output.
+    void run();
+
+private:
+    /// @brief The scene being benchmarked.
+    Scene &scene_;
+
+    /// @brief The number of frames to render.
+    size_t frames_;
+
+    /// @brief The fixed time step.
+    float deltaTime_;
+
+    /// @brief The input trace being replayed, nullptr if none.
+    InputTrace *trace_;
+};
+
+#endif //PROJECT_BENCHMARK_H
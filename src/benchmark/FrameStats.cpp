@@ -0,0 +1,138 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "FrameStats.h"
+
+#define HALF_SUB_BUCKETS (FRAME_STATS_SUB_BUCKETS / 2)
+// bit_width of FRAME_STATS_SUB_BUCKETS - 1
+#define SUB_BUCKET_BITS 7
+
+size_t FrameHistogram::index(uint64_t value) {
+    if (value < FRAME_STATS_SUB_BUCKETS) {
+        return value;
+    }
+    auto exponent = (size_t) std::bit_width(value) - SUB_BUCKET_BITS;
+    if (exponent > FRAME_STATS_MAX_EXPONENT) {
+        return FRAME_STATS_BUCKETS - 1;
+    }
+    // value >> exponent lies in [HALF_SUB_BUCKETS, FRAME_STATS_SUB_BUCKETS)
+    return FRAME_STATS_SUB_BUCKETS + (exponent - 1) * HALF_SUB_BUCKETS + ((value >> exponent) - HALF_SUB_BUCKETS);
+}
+
+uint64_t FrameHistogram::highest(size_t index) {
+    if (index < FRAME_STATS_SUB_BUCKETS) {
+        return index;
+    }
+    size_t exponent = (index - FRAME_STATS_SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+    uint64_t sub = (index - FRAME_STATS_SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+    return ((sub + 1) << exponent) - 1;
+}
+
+void FrameHistogram::add(uint64_t value) {
+    counts_[index(value)]++;
+    total++;
+}
+
+void FrameHistogram::remove(uint64_t value) {
+    counts_[index(value)]--;
+    total--;
+}
+
+uint64_t FrameHistogram::percentile(double percent) const {
+    if (total == 0) {
+        return 0;
+    }
+    auto target = (size_t) std::ceil(percent / 100.0 * (double) total);
+    target = std::clamp(target, (size_t) 1, total);
+    size_t seen = 0;
+    for (size_t i = 0; i < FRAME_STATS_BUCKETS; i++) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return highest(i);
+        }
+    }
+    return highest(FRAME_STATS_BUCKETS - 1);
+}
+
+void FrameStats::record(double seconds) {
+    auto value = (uint64_t) std::llround(std::max(seconds, 0.0) * 1.0e6);
+
+    if (window_.total == FRAME_STATS_WINDOW) {
+        window_.remove(frames_[frameIndex_]);
+        windowSum_ -= frames_[frameIndex_];
+    }
+    frames_[frameIndex_] = value;
+    frameIndex_ = (frameIndex_ + 1) % FRAME_STATS_WINDOW;
+    window_.add(value);
+    windowSum_ += value;
+
+    total_.add(value);
+    totalSum_ += value;
+    totalMax_ = std::max(totalMax_, value);
+}
+
+int FrameStats::fps() const {
+    if (windowSum_ == 0) {
+        return 0;
+    }
+    return (int) std::lround((double) window_.total * 1.0e6 / (double) windowSum_);
+}
+
+double FrameStats::percentile(double percent) const {
+    // a bucket reports its highest value, which must not exceed the frame actually seen
+    return std::min((double) window_.percentile(percent), max() * 1000.0) / 1000.0;
+}
+
+double FrameStats::max() const {
+    uint64_t result = 0;
+    for (size_t i = 0; i < window_.total; i++) {
+        result = std::max(result, frames_[i]);
+    }
+    return (double) result / 1000.0;
+}
+
+size_t FrameStats::count() const {
+    return window_.total;
+}
+
+double FrameStats::frameTime(size_t i) const {
+    size_t first = window_.total == FRAME_STATS_WINDOW ? frameIndex_ : 0;
+    return (double) frames_[(first + i) % FRAME_STATS_WINDOW] / 1000.0;
+}
+
+double FrameStats::totalPercentile(double percent) const {
+    return (double) std::min(total_.percentile(percent), totalMax_) / 1000.0;
+}
+
+void FrameStats::printSummary() const {
+    if (total_.total == 0) {
+        return;
+    }
+    std::printf("Frame times over %zu frames: avg %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+                total_.total, (double) totalSum_ / (double) total_.total / 1000.0, totalPercentile(50.0),
+                totalPercentile(95.0), totalPercentile(99.0), (double) totalMax_ / 1000.0);
+}
+
+bool FrameStats::writeSummary(const std::string &fileName) const {
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << fileName << " for the frame statistics" << std::endl;
+        return false;
+    }
+    double average = total_.total == 0 ? 0.0 : (double) totalSum_ / (double) total_.total / 1000.0;
+    file << "{\"frames\":" << total_.total
+         << ",\"avg_ms\":" << average
+         << ",\"p50_ms\":" << totalPercentile(50.0)
+         << ",\"p95_ms\":" << totalPercentile(95.0)
+         << ",\"p99_ms\":" << totalPercentile(99.0)
+         << ",\"max_ms\":" << (double) totalMax_ / 1000.0 << "}\n";
+    return true;
+}
@@ -0,0 +1,117 @@
+/// @file FrameStats.h
+/// @brief This file contains the definition of the FrameHistogram and FrameStats classes.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_FRAMESTATS_H
+#define PROJECT_FRAMESTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define FRAME_STATS_SUB_BUCKETS 128 ///< Number of linear buckets per power of two, gives under 1.6% error.
+#define FRAME_STATS_MAX_EXPONENT 26 ///< Frame times above 2^33 microseconds are clamped.
+#define FRAME_STATS_BUCKETS (FRAME_STATS_SUB_BUCKETS + FRAME_STATS_MAX_EXPONENT * FRAME_STATS_SUB_BUCKETS / 2)
+#define FRAME_STATS_WINDOW 240 ///< Number of the last frames the sliding statistics are computed over.
+
+/// @class FrameHistogram
+/// @brief A log-linear histogram of frame times in microseconds.
+/// @details Values below FRAME_STATS_SUB_BUCKETS get a bucket each; above that every power of two is split into
+/// FRAME_STATS_SUB_BUCKETS / 2 linear buckets, so the relative error is the same from microseconds to minutes.
+class FrameHistogram {
+public:
+    /// @brief The number of values in the histogram.
+    size_t total = 0;
+
+    /// @brief Adds a value to the histogram.
+    /// @param value The value in microseconds.
+    void add(uint64_t value);
+
+    /// @brief Removes a previously added value from the histogram.
+    /// @param value The value in microseconds.
+    void remove(uint64_t value);
+
+    /// @brief Gets the value below or at which the specified percentage of values lie.
+    /// @param percent The percentile, from 0 to 100.
+    /// @return The highest value equivalent to the bucket of the percentile, 0 if the histogram is empty.
+    uint64_t percentile(double percent) const;
+
+private:
+    /// @brief The number of values in every bucket.
+    uint32_t counts_[FRAME_STATS_BUCKETS] = {};
+
+    /// @brief Gets the bucket of a value.
+    static size_t index(uint64_t value);
+
+    /// @brief Gets the highest value of a bucket.
+    static uint64_t highest(size_t index);
+};
+
+/// @class FrameStats
+/// @brief The FrameStats class records every frame time and computes percentiles over them.
+/// @details The percentiles are available for the sliding window of the last FRAME_STATS_WINDOW frames, shown in
+/// the HUD, and for the whole run, written as a summary at exit.
+class FrameStats {
+public:
+    /// @brief Records the time of a frame.
+    /// @param seconds The frame time in seconds.
+    void record(double seconds);
+
+    /// @brief Gets the frames per second over the sliding window.
+    /// @return The frames per second.
+    int fps() const;
+
+    /// @brief Gets a percentile of the frame time over the sliding window.
+    /// @param percent The percentile, from 0 to 100.
+    /// @return The frame time in milliseconds.
+    double percentile(double percent) const;
+
+    /// @brief Gets the maximum frame time over the sliding window.
+    /// @return The frame time in milliseconds.
+    double max() const;
+
+    /// @brief Gets the number of frames in the sliding window.
+    /// @return The number of frames.
+    size_t count() const;
+
+    /// @brief Gets a frame time from the sliding window.
+    /// @param i The index of the frame, 0 is the oldest one.
+    /// @return The frame time in milliseconds.
+    double frameTime(size_t i) const;
+
+    /// @brief Prints the percentiles of the whole run to the standard output.
+    void printSummary() const;
+
+    /// @brief Writes the percentiles of the whole run to a JSON file.
+    /// @param fileName The name of the file.
+    /// @return True if the file was written, false otherwise.
+    bool writeSummary(const std::string &fileName) const;
+
+private:
+    /// @brief The histogram of the sliding window.
+    FrameHistogram window_;
+
+    /// @brief The histogram of the whole run.
+    FrameHistogram total_;
+
+    /// @brief The frame times of the sliding window in microseconds.
+    uint64_t frames_[FRAME_STATS_WINDOW] = {};
+
+    /// @brief The position in the window the next frame is written to.
+    size_t frameIndex_ = 0;
+
+    /// @brief The sum of the frame times in the window in microseconds.
+    uint64_t windowSum_ = 0;
+
+    /// @brief The maximum frame time of the whole run in microseconds.
+    uint64_t totalMax_ = 0;
+
+    /// @brief The sum of the frame times of the whole run in microseconds.
+    uint64_t totalSum_ = 0;
+
+    /// @brief Gets a percentile of the whole run.
+    double totalPercentile(double percent) const;
+};
+
+#endif //PROJECT_FRAMESTATS_H
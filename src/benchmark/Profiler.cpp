@@ -0,0 +1,75 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Profiler.h"
+
+std::string Profiler::fileName = "profile.json";
+
+/// @brief The zones of a single thread.
+struct ProfileRing {
+    std::vector<ProfileEvent> events = std::vector<ProfileEvent>(PROFILER_RING_SIZE);
+    size_t count = 0;
+    size_t thread = 0;
+};
+
+static const auto profilerStart = std::chrono::steady_clock::now();
+
+// rings outlive their threads, so a trace written at exit still contains the zones of finished threads
+static std::mutex ringsMutex;
+static std::vector<std::unique_ptr<ProfileRing>> rings;
+
+static ProfileRing *threadRing() {
+    thread_local ProfileRing *ring = nullptr;
+    if (ring == nullptr) {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(std::make_unique<ProfileRing>());
+        ring = rings.back().get();
+        ring->thread = rings.size();
+    }
+    return ring;
+}
+
+int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - profilerStart).count();
+}
+
+void Profiler::record(const char *name, int64_t start, int64_t end) {
+    ProfileRing *ring = threadRing();
+    ring->events[ring->count % PROFILER_RING_SIZE] = {name, start, end - start};
+    ring->count++;
+}
+
+bool Profiler::dump() {
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << fileName << " for the profiler trace" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    size_t written = 0;
+    file << "{\"traceEvents\":[";
+    for (auto &ring: rings) {
+        size_t first = ring->count > PROFILER_RING_SIZE ? ring->count - PROFILER_RING_SIZE : 0;
+        for (size_t i = first; i < ring->count; i++) {
+            const ProfileEvent &event = ring->events[i % PROFILER_RING_SIZE];
+            file << (written == 0 ? "\n" : ",\n")
+                 << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"ts\":" << event.start
+                 << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << ring->thread << "}";
+            written++;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::cout << "Profiler trace with " << written << " zones written to " << fileName << std::endl;
+    return true;
+}
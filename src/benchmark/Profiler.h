@@ -0,0 +1,85 @@
+/// @file Profiler.h
+/// @brief This file contains the definition of the Profiler class and the PROFILE_ZONE macro.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_PROFILER_H
+#define PROJECT_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define PROFILER_RING_SIZE 65536 ///< Number of zones kept per thread, the oldest ones are overwritten.
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+/// @brief Measures the rest of the enclosing scope as a zone with the specified name.
+/// @details The name must be a string literal, only the pointer is stored.
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+/// @struct ProfileEvent
+/// @brief A single finished zone.
+struct ProfileEvent {
+    /// @brief The name of the zone.
+    const char *name;
+
+    /// @brief The start time of the zone in microseconds since the profiler start.
+    int64_t start;
+
+    /// @brief The duration of the zone in microseconds.
+    int64_t duration;
+};
+
+/// @class Profiler
+/// @brief The Profiler class collects CPU zones and writes them as a Chrome trace.
+/// @details Every thread writes its zones to its own ring buffer, so recording takes no locks. The buffers are
+/// written in the Chrome trace_event JSON format, which can be opened in chrome://tracing or ui.perfetto.dev.
+class Profiler {
+public:
+    /// @brief The file the trace is written to.
+    static std::string fileName;
+
+    /// @brief Gets the current time in microseconds since the profiler start.
+    /// @return The current time.
+    static int64_t now();
+
+    /// @brief Adds a finished zone to the ring buffer of the calling thread.
+    /// @param name The name of the zone.
+    /// @param start The start time of the zone.
+    /// @param end The end time of the zone.
+    static void record(const char *name, int64_t start, int64_t end);
+
+    /// @brief Writes the zones of all threads to the trace file.
+    /// @details Should be called while the other threads are not recording.
+    /// @return True if the trace was written, false otherwise.
+    static bool dump();
+};
+
+/// @class ProfileZone
+/// @brief Records a zone from its construction to its destruction.
+class ProfileZone {
+public:
+    /// @brief Constructs a ProfileZone object and starts the zone.
+    /// @param name The name of the zone.
+    explicit ProfileZone(const char *name) : name_(name), start_(Profiler::now()) {}
+
+    /// @brief Destructor for ProfileZone, finishes the zone.
+    ~ProfileZone() {
+        Profiler::record(name_, start_, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone &) = delete;
+
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    /// @brief The name of the zone.
+    const char *name_;
+
+    /// @brief The start time of the zone.
+    int64_t start_;
+};
+
+#endif //PROJECT_PROFILER_H
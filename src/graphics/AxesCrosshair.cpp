@@ -4,6 +4,7 @@
 
 #include "GL/glew.h"
 #include "AxesCrosshair.h"
+#include "GLState.h"
 #include "glm/ext/matrix_transform.hpp"
 
 
@@ -16,7 +17,7 @@ void AxesCrosshair::init() {
     glGenVertexArrays(1, &this->vao);
     glGenBuffers(1, &this->vbo_);
 
-    glBindVertexArray(this->vao);
+    GLState::instance().bindVertexArray(this->vao);
 
     glBindBuffer(GL_ARRAY_BUFFER, this->vbo_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * lineVertices.size(), &lineVertices[0], GL_STATIC_DRAW);
@@ -28,13 +29,12 @@ void AxesCrosshair::init() {
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *) (3 * sizeof(float)));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
+    GLState::instance().bindVertexArray(0);
 }
 
 void AxesCrosshair::draw(Shader &shader) {
     glLineWidth(2.0f);
-    glBindVertexArray(this->vao);
+    GLState::instance().bindVertexArray(this->vao);
     glDrawArrays(GL_LINES, 0, 6);
-    glBindVertexArray(0);
     glLineWidth(1.0f);
 }
\ No newline at end of file
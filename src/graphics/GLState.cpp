@@ -0,0 +1,253 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "GL/glew.h"
+
+#include "GLState.h"
+
+GLState &GLState::instance() {
+    static GLState instance;
+    return instance;
+}
+
+GLState::GLState() {
+    invalidate();
+}
+
+void GLState::nextFrame() {
+    issued = frameIssued_;
+    elided = frameElided_;
+    frameIssued_ = 0;
+    frameElided_ = 0;
+}
+
+void GLState::invalidate() {
+    program_ = unknown_;
+    vao_ = unknown_;
+    activeUnit_ = unknown_;
+    for (auto &unit: textures_) {
+        unit[0] = unit[1] = unknown_;
+    }
+    readFramebuffer_ = drawFramebuffer_ = unknown_;
+    for (auto &capability: capabilities_) {
+        capability = -1;
+    }
+    stencilFunc_[0] = stencilFunc_[1] = stencilFunc_[2] = unknown_;
+    stencilOp_[0] = stencilOp_[1] = stencilOp_[2] = unknown_;
+    stencilMask_ = unknown_;
+    depthFunc_ = unknown_;
+    depthMask_ = unknown_;
+    blendFunc_[0] = blendFunc_[1] = unknown_;
+    polygonMode_ = unknown_;
+}
+
+bool GLState::change(unsigned int &value, unsigned int wanted) {
+    if (value == wanted) {
+        frameElided_++;
+        return false;
+    }
+    value = wanted;
+    frameIssued_++;
+    return true;
+}
+
+int GLState::capabilityIndex(unsigned int capability) {
+    switch (capability) {
+        case GL_BLEND:
+            return 0;
+        case GL_CULL_FACE:
+            return 1;
+        case GL_DEPTH_TEST:
+            return 2;
+        case GL_STENCIL_TEST:
+            return 3;
+        case GL_CLIP_DISTANCE0:
+        case GL_CLIP_DISTANCE1:
+        case GL_CLIP_DISTANCE2:
+        case GL_CLIP_DISTANCE3:
+            return 4 + (int) (capability - GL_CLIP_DISTANCE0);
+        default:
+            return -1;
+    }
+}
+
+int GLState::targetIndex(unsigned int target) {
+    switch (target) {
+        case GL_TEXTURE_2D:
+            return 0;
+        case GL_TEXTURE_CUBE_MAP:
+            return 1;
+        default:
+            return -1;
+    }
+}
+
+void GLState::useProgram(unsigned int program) {
+    if (change(program_, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLState::bindVertexArray(unsigned int vao) {
+    if (change(vao_, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLState::activeTexture(unsigned int unit) {
+    if (change(activeUnit_, unit - GL_TEXTURE0)) {
+        glActiveTexture(unit);
+    }
+}
+
+void GLState::bindTexture(unsigned int target, unsigned int texture) {
+    int slot = targetIndex(target);
+    if (slot < 0 || activeUnit_ >= GL_STATE_TEXTURE_UNITS) {
+        frameIssued_++;
+        glBindTexture(target, texture);
+        if (slot >= 0) {
+            // the binding of an unknown unit is not known either
+            for (auto &unit: textures_) {
+                unit[slot] = unknown_;
+            }
+        }
+        return;
+    }
+    if (change(textures_[activeUnit_][slot], texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+void GLState::bindFramebuffer(unsigned int target, unsigned int framebuffer) {
+    if (target == GL_FRAMEBUFFER) {
+        if (readFramebuffer_ == framebuffer && drawFramebuffer_ == framebuffer) {
+            frameElided_++;
+            return;
+        }
+        readFramebuffer_ = drawFramebuffer_ = framebuffer;
+        frameIssued_++;
+        glBindFramebuffer(target, framebuffer);
+        return;
+    }
+    if (change(target == GL_READ_FRAMEBUFFER ? readFramebuffer_ : drawFramebuffer_, framebuffer)) {
+        glBindFramebuffer(target, framebuffer);
+    }
+}
+
+void GLState::enable(unsigned int capability) {
+    int slot = capabilityIndex(capability);
+    if (slot >= 0 && capabilities_[slot] == 1) {
+        frameElided_++;
+        return;
+    }
+    if (slot >= 0) {
+        capabilities_[slot] = 1;
+    }
+    frameIssued_++;
+    glEnable(capability);
+}
+
+void GLState::disable(unsigned int capability) {
+    int slot = capabilityIndex(capability);
+    if (slot >= 0 && capabilities_[slot] == 0) {
+        frameElided_++;
+        return;
+    }
+    if (slot >= 0) {
+        capabilities_[slot] = 0;
+    }
+    frameIssued_++;
+    glDisable(capability);
+}
+
+void GLState::stencilFunc(unsigned int func, int ref, unsigned int mask) {
+    if (stencilFunc_[0] == func && stencilFunc_[1] == (unsigned int) ref && stencilFunc_[2] == mask) {
+        frameElided_++;
+        return;
+    }
+    stencilFunc_[0] = func;
+    stencilFunc_[1] = (unsigned int) ref;
+    stencilFunc_[2] = mask;
+    frameIssued_++;
+    glStencilFunc(func, ref, mask);
+}
+
+void GLState::stencilOp(unsigned int stencilFail, unsigned int depthFail, unsigned int depthPass) {
+    if (stencilOp_[0] == stencilFail && stencilOp_[1] == depthFail && stencilOp_[2] == depthPass) {
+        frameElided_++;
+        return;
+    }
+    stencilOp_[0] = stencilFail;
+    stencilOp_[1] = depthFail;
+    stencilOp_[2] = depthPass;
+    frameIssued_++;
+    glStencilOp(stencilFail, depthFail, depthPass);
+}
+
+void GLState::stencilMask(unsigned int mask) {
+    if (change(stencilMask_, mask)) {
+        glStencilMask(mask);
+    }
+}
+
+void GLState::depthFunc(unsigned int func) {
+    if (change(depthFunc_, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void GLState::depthMask(bool flag) {
+    if (change(depthMask_, flag ? GL_TRUE : GL_FALSE)) {
+        glDepthMask(flag ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void GLState::blendFunc(unsigned int source, unsigned int destination) {
+    if (blendFunc_[0] == source && blendFunc_[1] == destination) {
+        frameElided_++;
+        return;
+    }
+    blendFunc_[0] = source;
+    blendFunc_[1] = destination;
+    frameIssued_++;
+    glBlendFunc(source, destination);
+}
+
+void GLState::polygonMode(unsigned int mode) {
+    if (change(polygonMode_, mode)) {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+}
+
+void GLState::forgetProgram(unsigned int program) {
+    // a deleted program stays in use until another one is, only its name may be reused
+    if (program_ == program) {
+        program_ = unknown_;
+    }
+}
+
+void GLState::forgetVertexArray(unsigned int vao) {
+    if (vao_ == vao) {
+        vao_ = 0;
+    }
+}
+
+void GLState::forgetTexture(unsigned int texture) {
+    for (auto &unit: textures_) {
+        for (auto &binding: unit) {
+            if (binding == texture) {
+                binding = 0;
+            }
+        }
+    }
+}
+
+void GLState::forgetFramebuffer(unsigned int framebuffer) {
+    if (readFramebuffer_ == framebuffer) {
+        readFramebuffer_ = 0;
+    }
+    if (drawFramebuffer_ == framebuffer) {
+        drawFramebuffer_ = 0;
+    }
+}
@@ -0,0 +1,140 @@
+/// @file GLState.h
+/// @brief This file contains the definition of the GLState class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_GLSTATE_H
+#define PROJECT_GLSTATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define GL_STATE_TEXTURE_UNITS 16 ///< The number of texture units whose bindings are tracked.
+#define GL_STATE_CAPABILITIES 8 ///< The number of tracked capabilities, see GLState::capabilityIndex.
+
+/// @class GLState
+/// @brief The GLState class shadows the GL state the renderer changes and drops the calls that would not change it.
+/// @details The functions mirror the GL calls they replace. The tracked state is the program, the vertex array, the
+/// 2D and cube map textures of the first units, the read and draw framebuffers, the stencil, depth and blend state,
+/// the polygon mode and a few capabilities; every other call is passed through. All code changing the tracked state
+/// has to go through this class, and objects have to be forgotten when they are deleted, because GL unbinds them and
+/// a new object may get the same name. A value starts unknown, so the first call always reaches GL.
+class GLState {
+public:
+    /// @brief The number of calls passed to GL in the last frame.
+    size_t issued = 0;
+
+    /// @brief The number of redundant calls dropped in the last frame.
+    size_t elided = 0;
+
+    /// @brief Gets the state of the context, created on first use.
+    /// @return Reference to the state.
+    static GLState &instance();
+
+    /// @brief Moves the counters of the current frame to issued and elided and starts counting the next frame.
+    void nextFrame();
+
+    /// @brief Forgets all tracked values, for code that changed the state behind the cache.
+    void invalidate();
+
+    /// @brief glUseProgram.
+    void useProgram(unsigned int program);
+
+    /// @brief glBindVertexArray.
+    void bindVertexArray(unsigned int vao);
+
+    /// @brief glActiveTexture.
+    /// @param unit GL_TEXTURE0 + the index of the unit.
+    void activeTexture(unsigned int unit);
+
+    /// @brief glBindTexture on the active unit.
+    void bindTexture(unsigned int target, unsigned int texture);
+
+    /// @brief glBindFramebuffer, GL_FRAMEBUFFER binds both the read and the draw framebuffer.
+    void bindFramebuffer(unsigned int target, unsigned int framebuffer);
+
+    /// @brief glEnable.
+    void enable(unsigned int capability);
+
+    /// @brief glDisable.
+    void disable(unsigned int capability);
+
+    /// @brief glStencilFunc.
+    void stencilFunc(unsigned int func, int ref, unsigned int mask);
+
+    /// @brief glStencilOp.
+    void stencilOp(unsigned int stencilFail, unsigned int depthFail, unsigned int depthPass);
+
+    /// @brief glStencilMask.
+    void stencilMask(unsigned int mask);
+
+    /// @brief glDepthFunc.
+    void depthFunc(unsigned int func);
+
+    /// @brief glDepthMask.
+    void depthMask(bool flag);
+
+    /// @brief glBlendFunc.
+    void blendFunc(unsigned int source, unsigned int destination);
+
+    /// @brief glPolygonMode for GL_FRONT_AND_BACK.
+    void polygonMode(unsigned int mode);
+
+    /// @brief Forgets a program about to be deleted.
+    void forgetProgram(unsigned int program);
+
+    /// @brief Forgets a vertex array about to be deleted.
+    void forgetVertexArray(unsigned int vao);
+
+    /// @brief Forgets a texture about to be deleted.
+    void forgetTexture(unsigned int texture);
+
+    /// @brief Forgets a framebuffer about to be deleted.
+    void forgetFramebuffer(unsigned int framebuffer);
+
+private:
+    /// @brief The value of a binding or parameter that is not known.
+    static constexpr unsigned int unknown_ = ~0u;
+
+    /// @brief The calls passed to GL in the current frame.
+    size_t frameIssued_ = 0;
+
+    /// @brief The calls dropped in the current frame.
+    size_t frameElided_ = 0;
+
+    unsigned int program_ = unknown_; ///< The program in use.
+    unsigned int vao_ = unknown_; ///< The bound vertex array.
+    unsigned int activeUnit_ = unknown_; ///< The index of the active texture unit.
+    unsigned int textures_[GL_STATE_TEXTURE_UNITS][2]; ///< The 2D and cube map texture of every unit.
+    unsigned int readFramebuffer_ = unknown_; ///< The bound read framebuffer.
+    unsigned int drawFramebuffer_ = unknown_; ///< The bound draw framebuffer.
+    int8_t capabilities_[GL_STATE_CAPABILITIES]; ///< 1 if enabled, 0 if disabled, -1 if unknown.
+    unsigned int stencilFunc_[3]; ///< The stencil function, reference and mask.
+    unsigned int stencilOp_[3]; ///< The stencil operations.
+    unsigned int stencilMask_ = unknown_; ///< The stencil write mask.
+    unsigned int depthFunc_ = unknown_; ///< The depth function.
+    unsigned int depthMask_ = unknown_; ///< The depth write mask.
+    unsigned int blendFunc_[2]; ///< The source and destination blend factors.
+    unsigned int polygonMode_ = unknown_; ///< The polygon mode.
+
+    /// @brief Starts with all values unknown.
+    GLState();
+
+    /// @brief Counts a call and tells whether it changes a value.
+    /// @param value The tracked value, updated.
+    /// @param wanted The value the call sets.
+    /// @return True if the call has to reach GL.
+    bool change(unsigned int &value, unsigned int wanted);
+
+    /// @brief Gets the slot of a tracked capability.
+    /// @param capability The capability.
+    /// @return The slot, -1 if the capability is not tracked.
+    static int capabilityIndex(unsigned int capability);
+
+    /// @brief Gets the slot of a tracked texture target.
+    /// @param target The target.
+    /// @return The slot, -1 if the target is not tracked.
+    static int targetIndex(unsigned int target);
+};
+
+#endif //PROJECT_GLSTATE_H
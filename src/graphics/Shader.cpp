@@ -3,20 +3,29 @@
 //
 
 #include "Shader.h"
+#include "GLState.h"
 
 #define GLEW_STATIC
 
 #include <GL/glew.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 
+#define SHADER_MAX_INCLUDE_DEPTH 8 ///< Guards against files including each other.
+
+std::string Shader::defines;
+
 Shader::Shader(const char *vertex_path, const char *fragment_path) {
     this->id = loadShader(vertex_path, fragment_path);
     if (this->id == 0) {
         std::cerr << "Failed to create program." << std::endl;
         throw std::exception();
     }
+    reflect();
 }
 
 Shader::Shader(const char *vertex_path, const char *fragment_path, const char *geometry_path) {
@@ -25,58 +34,138 @@ Shader::Shader(const char *vertex_path, const char *fragment_path, const char *g
         std::cerr << "Failed to create program." << std::endl;
         throw std::exception();
     }
+    reflect();
 }
 
 Shader::~Shader() {
+    GLState::instance().forgetProgram(id);
     glDeleteProgram(id);
 }
 
 void Shader::use() {
-    glUseProgram(id);
+    GLState::instance().useProgram(id);
 }
 
-void Shader::uniformMatrix(const char *name, glm::mat4 matrix) {
-    int location = glGetUniformLocation(id, name);
-    glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]);
+void Shader::reflect() {
+    GLint count = 0, maxLength = 0;
+    glGetProgramInterfaceiv(id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+    glGetProgramInterfaceiv(id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxLength);
+
+    std::vector<std::string> names;
+    std::vector<char> buffer(std::max(maxLength, 1));
+    const GLenum properties[] = {GL_LOCATION, GL_ARRAY_SIZE};
+    for (GLint i = 0; i < count; i++) {
+        GLint values[2];
+        glGetProgramResourceiv(id, GL_UNIFORM, i, 2, properties, 2, nullptr, values);
+        // members of uniform blocks have no location
+        if (values[0] < 0) {
+            continue;
+        }
+        glGetProgramResourceName(id, GL_UNIFORM, i, (GLsizei) buffer.size(), nullptr, buffer.data());
+        std::string name = buffer.data();
+        names.push_back(name);
+        locations_.emplace_back(uniformHash(name), values[0]);
+
+        // an array is listed as name[0], its elements are also found by name and name[i]
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            std::string base = name.substr(0, name.size() - 3);
+            names.push_back(base);
+            locations_.emplace_back(uniformHash(base), values[0]);
+            for (GLint element = 1; element < values[1]; element++) {
+                names.push_back(base + "[" + std::to_string(element) + "]");
+                locations_.emplace_back(uniformHash(names.back()), values[0] + element);
+            }
+        }
+    }
+
+    std::vector<size_t> order(locations_.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return locations_[a] < locations_[b]; });
+    std::vector<std::pair<uint32_t, int>> sorted;
+    sorted.reserve(order.size());
+    for (size_t i: order) {
+        if (!sorted.empty() && sorted.back().first == locations_[i].first) {
+            std::cerr << "Uniform name hash collision in program " << id << ": " << names[i] << std::endl;
+            continue;
+        }
+        sorted.push_back(locations_[i]);
+    }
+    locations_.swap(sorted);
 }
 
-void Shader::uniformMat3(const char *name, glm::mat3 matrix) {
-    int location = glGetUniformLocation(id, name);
-    glUniformMatrix3fv(location, 1, GL_FALSE, &matrix[0][0]);
+int Shader::location(UniformName name) const {
+    auto it = std::lower_bound(locations_.begin(), locations_.end(), name.hash,
+                               [](const std::pair<uint32_t, int> &entry, uint32_t hash) { return entry.first < hash; });
+    if (it == locations_.end() || it->first != name.hash) {
+        return -1;
+    }
+    return it->second;
 }
 
-void Shader::uniformBool(const char *name, bool value) {
-    int location = glGetUniformLocation(id, name);
-    if (value)
-        glUniform1i(location, GL_TRUE);
-    else
-        glUniform1i(location, GL_FALSE);
+void Shader::set(Uniform<glm::mat4> uniform, const glm::mat4 &value) {
+    glProgramUniformMatrix4fv(id, uniform.location, 1, GL_FALSE, &value[0][0]);
 }
 
-void Shader::uniformInt(const char *name, int value) {
-    int location = glGetUniformLocation(id, name);
-    glUniform1i(location, value);
+void Shader::set(Uniform<glm::mat3> uniform, const glm::mat3 &value) {
+    glProgramUniformMatrix3fv(id, uniform.location, 1, GL_FALSE, &value[0][0]);
 }
 
+void Shader::set(Uniform<bool> uniform, bool value) {
+    glProgramUniform1i(id, uniform.location, value ? GL_TRUE : GL_FALSE);
+}
+
+void Shader::set(Uniform<int> uniform, int value) {
+    glProgramUniform1i(id, uniform.location, value);
+}
+
+void Shader::set(Uniform<glm::vec2> uniform, glm::vec2 value) {
+    glProgramUniform2fv(id, uniform.location, 1, &value[0]);
+}
 
-void Shader::uniformVec2(const char *name, glm::vec2 vec) {
-    int location = glGetUniformLocation(id, name);
-    glUniform2fv(location, 1, &vec[0]);
+void Shader::set(Uniform<glm::vec3> uniform, glm::vec3 value) {
+    glProgramUniform3fv(id, uniform.location, 1, &value[0]);
 }
 
-void Shader::uniformVec3(const char *name, glm::vec3 vec) {
-    int location = glGetUniformLocation(id, name);
-    glUniform3fv(location, 1, &vec[0]);
+void Shader::set(Uniform<glm::vec4> uniform, glm::vec4 value) {
+    glProgramUniform4fv(id, uniform.location, 1, &value[0]);
 }
 
-void Shader::uniformVec4(const char *name, glm::vec4 vec) {
-    int location = glGetUniformLocation(id, name);
-    glUniform4fv(location, 1, &vec[0]);
+void Shader::set(Uniform<float> uniform, float value) {
+    glProgramUniform1f(id, uniform.location, value);
 }
 
-void Shader::uniformFloat(const char *name, float value) {
-    int location = glGetUniformLocation(id, name);
-    glUniform1f(location, value);
+void Shader::uniformMatrix(UniformName name, glm::mat4 matrix) {
+    set(uniform<glm::mat4>(name), matrix);
+}
+
+void Shader::uniformMat3(UniformName name, glm::mat3 matrix) {
+    set(uniform<glm::mat3>(name), matrix);
+}
+
+void Shader::uniformBool(UniformName name, bool value) {
+    set(uniform<bool>(name), value);
+}
+
+void Shader::uniformInt(UniformName name, int value) {
+    set(uniform<int>(name), value);
+}
+
+void Shader::uniformVec2(UniformName name, glm::vec2 vec) {
+    set(uniform<glm::vec2>(name), vec);
+}
+
+void Shader::uniformVec3(UniformName name, glm::vec3 vec) {
+    set(uniform<glm::vec3>(name), vec);
+}
+
+void Shader::uniformVec4(UniformName name, glm::vec4 vec) {
+    set(uniform<glm::vec4>(name), vec);
+}
+
+void Shader::uniformFloat(UniformName name, float value) {
+    set(uniform<float>(name), value);
 }
 
 #define CHECK_GL_ERROR() do { checkGLError(__FUNCTION__, __LINE__); } while(0)
@@ -204,29 +293,47 @@ GLuint createShaderFromSource(GLenum eShaderType, const char *strFileData) {
     return shader;
 }
 
-GLuint createShaderFromFile(GLenum eShaderType, const char *filename) {
-    FILE *f = fopen(filename, "rb");
-    if (!f) {
+bool readShaderFile(const std::string &filename, std::string &source, int depth = 0) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
         std::cerr << "Unable to open file " << filename << " for reading." << std::endl;
-        return 0;
-    } else
-        std::cout << "loading shader: " << filename << std::endl;
-
-    fseek(f, 0, SEEK_END);
-    int length = ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    char buffer[length + 1];
-    int length_tmp = fread(buffer, 1, length, f);
-    if (length_tmp != length) {
-        std::cerr << "Error reading from file. Lengths are not equal." << filename << std::endl;
-        fclose(f);
+        return false;
+    }
+    std::string directory = filename.substr(0, filename.find_last_of("/\\") + 1);
+
+    // #include "file" is replaced by the content of the file, relative to the including one
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start != std::string::npos && line.compare(start, 8, "#include") == 0) {
+            size_t open = line.find('"', start);
+            size_t close = line.find('"', open + 1);
+            if (open == std::string::npos || close == std::string::npos || depth >= SHADER_MAX_INCLUDE_DEPTH) {
+                std::cerr << "Invalid include in " << filename << ": " << line << std::endl;
+                return false;
+            }
+            if (!readShaderFile(directory + line.substr(open + 1, close - open - 1), source, depth + 1)) {
+                return false;
+            }
+            continue;
+        }
+        source += line;
+        source += '\n';
+        if (depth == 0 && start != std::string::npos && line.compare(start, 8, "#version") == 0) {
+            source += Shader::defines;
+        }
+    }
+    return true;
+}
+
+GLuint createShaderFromFile(GLenum eShaderType, const char *filename) {
+    std::string source;
+    if (!readShaderFile(filename, source)) {
         return 0;
     }
-    fclose(f);
-    buffer[length] = '\0';
+    std::cout << "loading shader: " << filename << std::endl;
 
-    GLuint sh = createShaderFromSource(eShaderType, buffer);
+    GLuint sh = createShaderFromSource(eShaderType, source.c_str());
     return sh;
 }
 
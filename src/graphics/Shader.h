@@ -6,16 +6,64 @@
 #ifndef PROJECT_SHADER_H
 #define PROJECT_SHADER_H
 
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <glm/mat4x4.hpp>
 
+#define UNIFORM_HASH_OFFSET 2166136261u ///< The offset basis of the 32-bit FNV-1a hash.
+#define UNIFORM_HASH_PRIME 16777619u ///< The prime of the 32-bit FNV-1a hash.
+
+/// @brief Hashes a uniform name with 32-bit FNV-1a.
+/// @param name The name of the uniform.
+/// @return The hash of the name.
+constexpr uint32_t uniformHash(std::string_view name) {
+    uint32_t hash = UNIFORM_HASH_OFFSET;
+    for (char c: name) {
+        hash = (hash ^ (uint8_t) c) * UNIFORM_HASH_PRIME;
+    }
+    return hash;
+}
+
+/// @struct UniformName
+/// @brief The name of a uniform reduced to its hash, string literals are hashed at compile time.
+struct UniformName {
+    /// @brief The hash of the name.
+    uint32_t hash;
+
+    /// @brief Hashes a string literal at compile time.
+    /// @param name The name of the uniform.
+    template<size_t N>
+    consteval UniformName(const char (&name)[N]) : hash(uniformHash(std::string_view(name, N - 1))) {}
+
+    /// @brief Hashes a name built at run time.
+    /// @param name The name of the uniform.
+    explicit UniformName(std::string_view name) : hash(uniformHash(name)) {}
+};
+
+/// @struct Uniform
+/// @brief A handle to a uniform of a program with its location resolved, T is the type of its value.
+template<typename T>
+struct Uniform {
+    /// @brief The location of the uniform, -1 if the program has no such active uniform.
+    int location = -1;
+};
+
 /// @class Shader
 /// @brief The Shader class handles the compilation and management of shader programs.
 /// @details This class provides methods for loading, compiling, and using shaders, as well as setting uniform variables in the shader programs.
+/// The active uniforms are reflected once after linking into a table sorted by the hashes of their names, so setting
+/// a uniform by name is a binary search and a glProgramUniform call. Hot paths resolve a Uniform handle once instead.
 class Shader {
 public:
     /// @brief The ID of the shader program.
     unsigned int id;
 
+    /// @brief Preprocessor definitions inserted after the #version line of every shader loaded afterwards.
+    static std::string defines;
+
     /// @brief Constructs a Shader object with the specified vertex and fragment shader paths.
     /// @param vertex_path The file path to the vertex shader.
     /// @param fragment_path The file path to the fragment shader.
@@ -33,45 +81,96 @@ public:
     /// @brief Uses the shader program.
     void use();
 
+    /// @brief Gets the location of an active uniform.
+    /// @param name The name of the uniform.
+    /// @return The location, -1 if the program has no such active uniform.
+    int location(UniformName name) const;
+
+    /// @brief Resolves a handle to a uniform.
+    /// @param name The name of the uniform.
+    /// @return The handle.
+    template<typename T>
+    Uniform<T> uniform(UniformName name) const { return {location(name)}; }
+
+    /// @brief Sets a mat4 uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<glm::mat4> uniform, const glm::mat4 &value);
+
+    /// @brief Sets a mat3 uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<glm::mat3> uniform, const glm::mat3 &value);
+
+    /// @brief Sets a bool uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<bool> uniform, bool value);
+
+    /// @brief Sets an int uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<int> uniform, int value);
+
+    /// @brief Sets a vec2 uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<glm::vec2> uniform, glm::vec2 value);
+
+    /// @brief Sets a vec3 uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<glm::vec3> uniform, glm::vec3 value);
+
+    /// @brief Sets a vec4 uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<glm::vec4> uniform, glm::vec4 value);
+
+    /// @brief Sets a float uniform through its handle, the program does not have to be in use.
+    /// @param uniform The handle of the uniform.
+    /// @param value The value to set.
+    void set(Uniform<float> uniform, float value);
+
     /// @brief Sets a mat4 uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param matrix The mat4 value to set.
-    void uniformMatrix(const char *name, glm::mat4 matrix);
+    void uniformMatrix(UniformName name, glm::mat4 matrix);
 
     /// @brief Sets a mat3 uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param matrix The mat3 value to set.
-    void uniformMat3(const char *name, glm::mat3 matrix);
+    void uniformMat3(UniformName name, glm::mat3 matrix);
 
     /// @brief Sets a bool uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param value The bool value to set.
-    void uniformBool(const char *name, bool value);
+    void uniformBool(UniformName name, bool value);
 
     /// @brief Sets an int uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param value The int value to set.
-    void uniformInt(const char *name, int value);
+    void uniformInt(UniformName name, int value);
 
     /// @brief Sets a vec2 uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param vec The vec2 value to set.
-    void uniformVec2(const char *name, glm::vec2 vec);
+    void uniformVec2(UniformName name, glm::vec2 vec);
 
     /// @brief Sets a vec3 uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param vec The vec3 value to set.
-    void uniformVec3(const char *name, glm::vec3 vec);
+    void uniformVec3(UniformName name, glm::vec3 vec);
 
     /// @brief Sets a vec4 uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param vec The vec4 value to set.
-    void uniformVec4(const char *name, glm::vec4 vec);
+    void uniformVec4(UniformName name, glm::vec4 vec);
 
     /// @brief Sets a float uniform variable in the shader.
     /// @param name The name of the uniform variable.
     /// @param value The float value to set.
-    void uniformFloat(const char *name, float value);
+    void uniformFloat(UniformName name, float value);
 
     /// @brief Loads and compiles a shader program with vertex and fragment shaders.
     /// @param vertex_path The file path to the vertex shader.
@@ -85,6 +184,13 @@ public:
     /// @param geometry_path The file path to the geometry shader.
     /// @return The ID of the compiled shader program.
     unsigned int loadShader(const char *vertex_path, const char *fragment_path, const char *geometry_path);
+
+private:
+    /// @brief The hashes of the names of the active uniforms with their locations, sorted by hash.
+    std::vector<std::pair<uint32_t, int>> locations_;
+
+    /// @brief Fills the location table from the active uniforms of the linked program.
+    void reflect();
 };
 
 /// @brief Checks for OpenGL errors and reports them.
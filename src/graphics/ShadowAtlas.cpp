@@ -0,0 +1,103 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "GL/glew.h"
+#include "ShadowAtlas.h"
+#include "GLState.h"
+
+unsigned int ShadowAtlas::defaultSize = SHADOW_ATLAS_SIZE;
+
+ShadowAtlas::ShadowAtlas(unsigned int size) : size(size) {
+    glGenFramebuffers(1, &depthMapFBO);
+
+    glGenTextures(1, &texture);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, (int) size, (int) size);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // bind texture to framebuffer
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0);
+
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    reset();
+}
+
+void ShadowAtlas::bind() {
+    GLState::instance().bindTexture(GL_TEXTURE_2D, texture);
+}
+
+void ShadowAtlas::reset() {
+    size_t levels = 1;
+    while ((size >> (levels - 1)) > SHADOW_TILE_MIN) {
+        levels++;
+    }
+    freeTiles_.assign(levels, {});
+    freeTiles_[0].emplace_back(0, 0);
+    usedTexels = 0;
+}
+
+bool ShadowAtlas::allocateTile(size_t level, glm::uvec2 &offset) {
+    // the smallest free tile that is at least as large, split down to the requested size
+    size_t from = level + 1;
+    while (from > 0 && freeTiles_[from - 1].empty()) {
+        from--;
+    }
+    if (from == 0) {
+        return false;
+    }
+    from--;
+    offset = freeTiles_[from].back();
+    freeTiles_[from].pop_back();
+    for (size_t split = from + 1; split <= level; split++) {
+        unsigned int half = size >> split;
+        freeTiles_[split].emplace_back(offset.x + half, offset.y);
+        freeTiles_[split].emplace_back(offset.x, offset.y + half);
+        freeTiles_[split].emplace_back(offset.x + half, offset.y + half);
+    }
+    return true;
+}
+
+bool ShadowAtlas::allocate(unsigned int tileSize, unsigned int faces, ShadowTiles &tiles) {
+    size_t level = 0;
+    while ((size >> level) > tileSize) {
+        level++;
+    }
+    if (level >= freeTiles_.size() || (size >> level) != tileSize) {
+        tiles.size = 0;
+        return false;
+    }
+
+    // tiles of the same size fit as long as the free area does, the buddy tiles leave no holes
+    size_t freeTexels = (size_t) size * size - usedTexels;
+    if (freeTexels < faces * (size_t) tileSize * tileSize) {
+        tiles.size = 0;
+        return false;
+    }
+    for (unsigned int face = 0; face < faces; face++) {
+        if (!allocateTile(level, tiles.offsets[face])) {
+            tiles.size = 0;
+            return false;
+        }
+        usedTexels += (size_t) tileSize * tileSize;
+    }
+    tiles.size = tileSize;
+    tiles.faces = faces;
+    return true;
+}
+
+void ShadowAtlas::clear(const ShadowTiles &tiles) {
+    float depth = 1.0f;
+    for (unsigned int face = 0; face < tiles.faces; face++) {
+        glClearTexSubImage(texture, 0, (int) tiles.offsets[face].x, (int) tiles.offsets[face].y, 0, (int) tiles.size,
+                           (int) tiles.size, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &depth);
+    }
+}
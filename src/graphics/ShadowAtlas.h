@@ -0,0 +1,84 @@
+/// @file ShadowAtlas.h
+/// @brief This file contains the definition of the ShadowAtlas class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_SHADOWATLAS_H
+#define PROJECT_SHADOWATLAS_H
+
+#include <vector>
+#include "glm/vec2.hpp"
+
+#define SHADOW_ATLAS_SIZE 4096 ///< The default width and height of the atlas in texels.
+#define SHADOW_TILE_MIN 128 ///< The smallest tile a cube face gets.
+#define SHADOW_TILE_MAX 1024 ///< The largest tile a cube face gets.
+
+/// @struct ShadowTiles
+/// @brief The tiles of the cube faces of a point light, or the single tile of a spot light.
+struct ShadowTiles {
+    /// @brief The width and height of every tile in texels, 0 if the light got no tiles.
+    unsigned int size = 0;
+
+    /// @brief The number of tiles, 6 for a cube and 1 for a spot light.
+    unsigned int faces = 0;
+
+    /// @brief The corner of the tile of every face in texels.
+    glm::uvec2 offsets[6] = {};
+
+    bool operator==(const ShadowTiles &other) const = default;
+};
+
+/// @class ShadowAtlas
+/// @brief The ShadowAtlas class handles a single depth texture the shadow maps of all lights are packed into.
+/// @details The tiles are power of two squares handed out by a buddy allocator, so tiles allocated from the largest
+/// to the smallest pack without gaps. The whole atlas is reallocated whenever the tile size of a light changes.
+class ShadowAtlas {
+public:
+    /// @brief The atlas size used by new atlases, set from the command line.
+    static unsigned int defaultSize;
+
+    /// @brief The width and height of the atlas in texels.
+    const unsigned int size;
+
+    /// @brief The ID of the depth texture.
+    unsigned int texture;
+
+    /// @brief The ID of the framebuffer object for the depth map.
+    unsigned int depthMapFBO;
+
+    /// @brief The number of texels covered by the allocated tiles.
+    size_t usedTexels = 0;
+
+    /// @brief Constructs a ShadowAtlas object with a square depth texture.
+    /// @param size The width and height of the atlas in texels, a power of two.
+    explicit ShadowAtlas(unsigned int size);
+
+    /// @brief Binds the depth texture for use in rendering.
+    void bind();
+
+    /// @brief Frees all tiles.
+    void reset();
+
+    /// @brief Allocates the tiles of the faces of a light.
+    /// @param tileSize The size of every tile, a power of two between SHADOW_TILE_MIN and SHADOW_TILE_MAX.
+    /// @param faces The number of tiles, at most 6.
+    /// @param tiles The tiles receiving the offsets.
+    /// @return True if the tiles were allocated, false if the atlas is full.
+    bool allocate(unsigned int tileSize, unsigned int faces, ShadowTiles &tiles);
+
+    /// @brief Clears the depth of the tiles of a light to the far plane.
+    /// @param tiles The tiles to clear.
+    void clear(const ShadowTiles &tiles);
+
+private:
+    /// @brief The free tiles of every size, the first list holds the tiles of the whole atlas size.
+    std::vector<std::vector<glm::uvec2>> freeTiles_;
+
+    /// @brief Allocates one tile.
+    /// @param level The level of the tile, the tile size is size >> level.
+    /// @param offset The corner of the tile.
+    /// @return True if a tile was found.
+    bool allocateTile(size_t level, glm::uvec2 &offset);
+};
+
+#endif //PROJECT_SHADOWATLAS_H
@@ -4,59 +4,95 @@
 
 #include <iostream>
 #include "gBuffer.h"
+#include "GLState.h"
 #include "GL/glew.h"
 #include "../window/Window.h"
 
-gBuffer::gBuffer() {
+bool gBuffer::compact = true;
+
+// creates a render target and attaches it to the bound framebuffer
+static unsigned int createTarget(int width, int height, GLenum internalFormat, GLenum format, GLenum type,
+                                 GLenum attachment, GLint filter = GL_NEAREST) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint) internalFormat, width, height, 0, format, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+    return texture;
+}
+
+gBuffer::gBuffer() : width(Window::WIDTH), height(Window::HEIGHT) {
+    create();
+}
+
+void gBuffer::resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height) {
+        return;
+    }
+    destroy();
+    width = newWidth;
+    height = newHeight;
+    create();
+}
+
+void gBuffer::destroy() {
+    unsigned int textures[] = {gPosition, gNormal, gDiffuseShininess, gAmbientSpecular, gObjectID, gDepth,
+                               gLighting};
+    for (unsigned int texture: textures) {
+        if (texture != 0) {
+            GLState::instance().forgetTexture(texture);
+            glDeleteTextures(1, &texture);
+        }
+    }
+    GLState::instance().forgetFramebuffer(gbuffer);
+    GLState::instance().forgetFramebuffer(lightingFBO);
+    glDeleteFramebuffers(1, &gbuffer);
+    glDeleteFramebuffers(1, &lightingFBO);
+}
+
+void gBuffer::create() {
     // configure g-buffer framebuffer
     // ------------------------------
     glGenFramebuffers(1, &gbuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer);
-    // position color buffer
-    glGenTextures(1, &gPosition);
-    glBindTexture(GL_TEXTURE_2D, gPosition);
-                                    // GL_RGB16F non enough for smooth lighting!
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, Window::WIDTH, Window::HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, gPosition, 0);
-    // normal color buffer
-    glGenTextures(1, &gNormal);
-    glBindTexture(GL_TEXTURE_2D, gNormal);
-    // TODO Maybe GL_RGB16F enough!
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, Window::WIDTH, Window::HEIGHT, 0, GL_RGB, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, gNormal, 0);
-    // diffuse + shininess color buffer
-    glGenTextures(1, &gDiffuseShininess);
-    glBindTexture(GL_TEXTURE_2D, gDiffuseShininess);
-    // TODO Maybe GL_RGBA16F enough!
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, Window::WIDTH, Window::HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, gDiffuseShininess, 0);
-
-    // specular color buffer
-    glGenTextures(1, &gAmbientSpecular);
-    glBindTexture(GL_TEXTURE_2D, gAmbientSpecular);
-    // TODO Maybe GL_RGBA16F enough!
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, Window::WIDTH, Window::HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, gAmbientSpecular, 0);
-
-
-    // tell OpenGL which color attachments we'll use for rendering
-    glDrawBuffers(4, attachments);
-    // create and attach depth buffer (renderbuffer)
-    glGenRenderbuffers(1, &rboDepth);
-    glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Window::WIDTH, Window::HEIGHT);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, gbuffer);
+
+    if (compact) {
+        // 16 bytes per pixel: octahedral normal, diffuse + log shininess, ambient + specular, depth + stencil
+        gPosition = 0;
+        gNormal = createTarget(width, height, GL_RG16_SNORM, GL_RG, GL_FLOAT, GL_COLOR_ATTACHMENT0);
+        gDiffuseShininess = createTarget(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT1);
+        gAmbientSpecular = createTarget(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT2);
+        objectIDBuffer = 3;
+    } else {
+        // GL_RGB16F non enough for smooth lighting!
+        gPosition = createTarget(width, height, GL_RGB32F, GL_RGB, GL_FLOAT, GL_COLOR_ATTACHMENT0);
+        gNormal = createTarget(width, height, GL_RGB32F, GL_RGB, GL_FLOAT, GL_COLOR_ATTACHMENT1);
+        gDiffuseShininess = createTarget(width, height, GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_COLOR_ATTACHMENT2);
+        gAmbientSpecular = createTarget(width, height, GL_RGBA32F, GL_RGBA, GL_FLOAT, GL_COLOR_ATTACHMENT3);
+        objectIDBuffer = 4;
+    }
+
+    // the ID of the object covering the pixel, read back for picking
+    gObjectID = createTarget(width, height, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                             attachments[objectIDBuffer]);
+    glDrawBuffers((GLsizei) objectIDBuffer + 1, attachments);
+
+    // depth + stencil as a texture, the lighting pass reconstructs the position from it
+    gDepth = createTarget(width, height, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, GL_DEPTH_STENCIL_ATTACHMENT);
 
     // finally check if framebuffer is complete
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         std::cout << "Framebuffer not complete!" << std::endl;
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
\ No newline at end of file
+
+    // the lit image, filtered when it is scaled up to the window
+    glGenFramebuffers(1, &lightingFBO);
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, lightingFBO);
+    gLighting = createTarget(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT0, GL_LINEAR);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Lighting framebuffer not complete!" << std::endl;
+    GLState::instance().bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -11,12 +11,19 @@
 /// @class gBuffer
 /// @brief The gBuffer class is used to handle the creation and management of a G-buffer for deferred shading.
 /// @details This class initializes and manages the G-buffer, which contains multiple render targets for storing various components needed in deferred shading.
+/// In the compact layout the position is reconstructed from the depth texture, normals are octahedral RG16 and the
+/// colors RGBA8 with log-encoded shininess (16 bytes per pixel, plus 4 for the object ID used for picking). The full layout stores everything as 32-bit floats
+/// (60 bytes per pixel) and is kept for comparison. The deferred passes may render into a smaller part of the
+/// textures, which are only reallocated when the window size changes.
 class gBuffer {
 public:
+    /// @brief Selects the compact layout for G-buffers created afterwards, the shaders need GBUFFER_FULL otherwise.
+    static bool compact;
+
     /// @brief The ID of the G-buffer.
     unsigned int gbuffer;
 
-    /// @brief The ID of the texture storing positions.
+    /// @brief The ID of the texture storing positions, 0 in the compact layout.
     unsigned int gPosition;
 
     /// @brief The ID of the texture storing normals.
@@ -28,14 +35,45 @@ public:
     /// @brief The ID of the texture storing ambient and specular color.
     unsigned int gAmbientSpecular;
 
-    /// @brief The ID of the render buffer object for depth.
-    unsigned int rboDepth;
+    /// @brief The ID of the R32UI texture storing the ID of the object covering each pixel, 0 where there is none.
+    unsigned int gObjectID;
+
+    /// @brief The index of the object ID texture among the draw buffers, for glClearBufferuiv and glColorMaski.
+    unsigned int objectIDBuffer;
+
+    /// @brief The ID of the texture storing depth and stencil.
+    unsigned int gDepth;
+
+    /// @brief The ID of the framebuffer the lighting pass renders into before the upscale.
+    unsigned int lightingFBO;
+
+    /// @brief The ID of the texture storing the lit image.
+    unsigned int gLighting;
+
+    /// @brief The width of the textures in pixels.
+    int width = 0;
+
+    /// @brief The height of the textures in pixels.
+    int height = 0;
 
     /// @brief Array of color attachments.
-    unsigned int attachments[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+    unsigned int attachments[5] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3,
+                                    GL_COLOR_ATTACHMENT4 };
 
-    /// @brief Constructs a gBuffer object and initializes the G-buffer.
+    /// @brief Constructs a gBuffer object and initializes the G-buffer at the size of the window.
     gBuffer();
+
+    /// @brief Reallocates the textures if the size changed.
+    /// @param newWidth The new width in pixels.
+    /// @param newHeight The new height in pixels.
+    void resize(int newWidth, int newHeight);
+
+private:
+    /// @brief Creates the framebuffers and textures at the current size.
+    void create();
+
+    /// @brief Deletes the framebuffers and textures.
+    void destroy();
 };
 
 #endif //PROJECT_GBUFFER_H
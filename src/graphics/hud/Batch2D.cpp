@@ -3,6 +3,7 @@
 #include "Batch2D.h"
 #include "../Texture.h"
 #include "../models/Mesh.h"
+#include "../../benchmark/Profiler.h"
 
 #define VERTEX_SIZE 8
 
@@ -91,6 +92,7 @@ void Batch2D::rect(float x, float y, float w, float h,
 }
 
 void Batch2D::render() {
+    PROFILE_ZONE("Batch2D::render");
     mesh->reload(buffer, index / VERTEX_SIZE);
     mesh->drawUi();
     index = 0;
@@ -31,6 +31,9 @@ public:
     /// @brief The radius of the light.
     float radius = 100.0f;
 
+    /// @brief Flag indicating whether the light casts shadows, as long as the shadow budget allows it.
+    bool castShadows = true;
+
     /// @brief The near plane for the light's projection.
     float near_plane = 1.0f;
 
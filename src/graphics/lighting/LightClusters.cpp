@@ -0,0 +1,129 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define LIGHT_CLUSTERS_SSE
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "LightClusters.h"
+#include "Lighting.h"
+#include "../../benchmark/Profiler.h"
+
+int LightClusters::slice(float depth) const {
+    if (depth <= zNear) {
+        return 0;
+    }
+    auto result = (int) (std::log(depth / zNear) / std::log(zFar / zNear) * CLUSTERS_Z);
+    return std::clamp(result, 0, CLUSTERS_Z - 1);
+}
+
+void LightClusters::buildBoxes(const glm::mat4 &projection) {
+    projection_ = projection;
+    // near and far planes of a glm::perspective matrix
+    zNear = projection[3][2] / (projection[2][2] - 1.0f);
+    zFar = projection[3][2] / (projection[2][2] + 1.0f);
+
+    minX_.resize(CLUSTERS_COUNT);
+    minY_.resize(CLUSTERS_COUNT);
+    minZ_.resize(CLUSTERS_COUNT);
+    maxX_.resize(CLUSTERS_COUNT);
+    maxY_.resize(CLUSTERS_COUNT);
+    maxZ_.resize(CLUSTERS_COUNT);
+    for (int z = 0; z < CLUSTERS_Z; z++) {
+        float sliceNear = zNear * std::pow(zFar / zNear, (float) z / CLUSTERS_Z);
+        float sliceFar = zNear * std::pow(zFar / zNear, (float) (z + 1) / CLUSTERS_Z);
+        for (int y = 0; y < CLUSTERS_Y; y++) {
+            for (int x = 0; x < CLUSTERS_X; x++) {
+                // the tile corners in NDC unprojected to both slice planes, the view looks along -z
+                float ndcX0 = -1.0f + 2.0f * (float) x / CLUSTERS_X;
+                float ndcX1 = -1.0f + 2.0f * (float) (x + 1) / CLUSTERS_X;
+                float ndcY0 = -1.0f + 2.0f * (float) y / CLUSTERS_Y;
+                float ndcY1 = -1.0f + 2.0f * (float) (y + 1) / CLUSTERS_Y;
+                float xs[4] = {ndcX0 * sliceNear, ndcX1 * sliceNear, ndcX0 * sliceFar, ndcX1 * sliceFar};
+                float ys[4] = {ndcY0 * sliceNear, ndcY1 * sliceNear, ndcY0 * sliceFar, ndcY1 * sliceFar};
+
+                size_t i = x + CLUSTERS_X * (y + CLUSTERS_Y * z);
+                minX_[i] = *std::min_element(xs, xs + 4) / projection[0][0];
+                maxX_[i] = *std::max_element(xs, xs + 4) / projection[0][0];
+                minY_[i] = *std::min_element(ys, ys + 4) / projection[1][1];
+                maxY_[i] = *std::max_element(ys, ys + 4) / projection[1][1];
+                minZ_[i] = -sliceFar;
+                maxZ_[i] = -sliceNear;
+            }
+        }
+    }
+}
+
+void LightClusters::build(const glm::mat4 &view, const glm::mat4 &projection, const LightData *lights,
+                          size_t lightsCount) {
+    PROFILE_ZONE("LightClusters::build");
+    if (projection != projection_) {
+        buildBoxes(projection);
+    }
+
+    pairs_.clear();
+    const size_t sliceSize = CLUSTERS_X * CLUSTERS_Y;
+    for (size_t light = 0; light < lightsCount; light++) {
+        glm::vec3 center = glm::vec3(view * glm::vec4(lights[light].position, 1.0f));
+        float radius = lights[light].attenuation.r;
+        float depth = -center.z;
+        if (depth + radius < zNear || depth - radius > zFar) {
+            continue;
+        }
+        size_t first = slice(depth - radius) * sliceSize;
+        size_t last = (slice(depth + radius) + 1) * sliceSize;
+        float radius2 = radius * radius;
+
+        size_t i = first;
+#ifdef LIGHT_CLUSTERS_SSE
+        __m128 cx = _mm_set1_ps(center.x);
+        __m128 cy = _mm_set1_ps(center.y);
+        __m128 cz = _mm_set1_ps(center.z);
+        __m128 r2 = _mm_set1_ps(radius2);
+        for (; i + 4 <= last; i += 4) {
+            // squared distance from the center to the closest point of every box
+            __m128 dx = _mm_sub_ps(_mm_min_ps(_mm_max_ps(cx, _mm_loadu_ps(&minX_[i])), _mm_loadu_ps(&maxX_[i])), cx);
+            __m128 dy = _mm_sub_ps(_mm_min_ps(_mm_max_ps(cy, _mm_loadu_ps(&minY_[i])), _mm_loadu_ps(&maxY_[i])), cy);
+            __m128 dz = _mm_sub_ps(_mm_min_ps(_mm_max_ps(cz, _mm_loadu_ps(&minZ_[i])), _mm_loadu_ps(&maxZ_[i])), cz);
+            __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            int mask = _mm_movemask_ps(_mm_cmple_ps(distance2, r2));
+            for (int lane = 0; lane < 4; lane++) {
+                if (mask & (1 << lane)) {
+                    pairs_.emplace_back((uint32_t) (i + lane), (uint32_t) light);
+                }
+            }
+        }
+#endif
+        for (; i < last; i++) {
+            float dx = std::clamp(center.x, minX_[i], maxX_[i]) - center.x;
+            float dy = std::clamp(center.y, minY_[i], maxY_[i]) - center.y;
+            float dz = std::clamp(center.z, minZ_[i], maxZ_[i]) - center.z;
+            if (dx * dx + dy * dy + dz * dz <= radius2) {
+                pairs_.emplace_back((uint32_t) i, (uint32_t) light);
+            }
+        }
+    }
+
+    // counting sort of the pairs by cluster
+    std::fill(grid.begin(), grid.end(), 0);
+    for (auto &pair: pairs_) {
+        grid[2 * pair.first + 1]++;
+    }
+    uint32_t offset = 0;
+    for (size_t cluster = 0; cluster < CLUSTERS_COUNT; cluster++) {
+        grid[2 * cluster] = offset;
+        offset += grid[2 * cluster + 1];
+        grid[2 * cluster + 1] = 0;
+    }
+    lightIndices.resize(pairs_.size());
+    for (auto &pair: pairs_) {
+        uint32_t &count = grid[2 * pair.first + 1];
+        lightIndices[grid[2 * pair.first] + count] = pair.second;
+        count++;
+    }
+}
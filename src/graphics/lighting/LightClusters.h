@@ -0,0 +1,68 @@
+/// @file LightClusters.h
+/// @brief This file contains the definition of the LightClusters class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_LIGHTCLUSTERS_H
+#define PROJECT_LIGHTCLUSTERS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/mat4x4.hpp"
+
+// the same values are defined in res/shaderLighting.frag
+#define CLUSTERS_X 16 ///< Number of screen tiles along x.
+#define CLUSTERS_Y 9 ///< Number of screen tiles along y.
+#define CLUSTERS_Z 24 ///< Number of exponential depth slices.
+#define CLUSTERS_COUNT (CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z)
+
+struct LightData;
+
+/// @class LightClusters
+/// @brief The LightClusters class assigns lights to the froxels (clusters) of the view frustum.
+/// @details The frustum is split into screen tiles and exponential depth slices. Every light's sphere is tested
+/// against the view-space boxes of the clusters in the depth slices it reaches, four boxes at a time with SSE.
+/// The result is a compact list of light indices and an (offset, count) pair per cluster, which the lighting
+/// shader uses to iterate only the lights that can reach a pixel. The class does not touch OpenGL.
+class LightClusters {
+public:
+    /// @brief The offset into lightIndices and the number of lights of every cluster.
+    std::vector<uint32_t> grid = std::vector<uint32_t>(2 * CLUSTERS_COUNT);
+
+    /// @brief The light indices of all clusters, stored cluster after cluster.
+    std::vector<uint32_t> lightIndices;
+
+    /// @brief The near plane distance of the last build.
+    float zNear = 0.1f;
+
+    /// @brief The far plane distance of the last build.
+    float zFar = 500.0f;
+
+    /// @brief Assigns the lights to the clusters.
+    /// @param view The view matrix of the camera.
+    /// @param projection The perspective projection matrix of the camera.
+    /// @param lights The data of the lights, with the position and the radius.
+    /// @param lightsCount The number of lights.
+    void build(const glm::mat4 &view, const glm::mat4 &projection, const LightData *lights, size_t lightsCount);
+
+    /// @brief Gets the depth slice of a view-space distance.
+    /// @param depth The distance along the view direction.
+    /// @return The slice, clamped to the valid range.
+    int slice(float depth) const;
+
+private:
+    /// @brief The projection the cluster boxes were built for.
+    glm::mat4 projection_ = glm::mat4(0.0f);
+
+    /// @brief The view-space boxes of the clusters, one array per axis, ordered slice by slice.
+    std::vector<float> minX_, minY_, minZ_, maxX_, maxY_, maxZ_;
+
+    /// @brief The (cluster, light) pairs of the current build.
+    std::vector<std::pair<uint32_t, uint32_t>> pairs_;
+
+    /// @brief Recalculates the cluster boxes for a new projection.
+    void buildBoxes(const glm::mat4 &projection);
+};
+
+#endif //PROJECT_LIGHTCLUSTERS_H
@@ -6,17 +6,19 @@
 #include "glm/ext/matrix_clip_space.hpp"
 #include "glm/ext/matrix_transform.hpp"
 
+#include <cmath>
 #include <cstring>
 #include <memory>
 #include <random>
 #include <iostream>
 
 #include "Lighting.h"
+#include "../../benchmark/Profiler.h"
+#include "../GLState.h"
 
 
 Lighting::Lighting() {
-    createUBO();
-    memset(lightsData, 0, sizeof(LightData) * MAX_LIGHTS);
+    createSSBO();
     update();
 
     sun.direction = glm::vec3(1.0f, -1.0f, 1.0f);
@@ -25,12 +27,13 @@ Lighting::Lighting() {
 
 }
 
-void Lighting::createUBO() {
-    glGenBuffers(1, &ubo);
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightData) * MAX_LIGHTS, 0, GL_STATIC_DRAW);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, ubo);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+void Lighting::createSSBO() {
+    capacity_ = LIGHTS_INITIAL_CAPACITY;
+    glGenBuffers(1, &ssbo);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(LightData) * capacity_, 0, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
 }
 
@@ -45,9 +48,21 @@ void Lighting::addSpotLight(size_t ID, glm::vec3 position, glm::vec3 color, glm:
 }
 
 void Lighting::update() {
+    PROFILE_ZONE("Lighting::update");
 
+    size_t previousCount = lightsData.size();
+    lightsData.resize(lights.size());
+    if (lightsData.size() > previousCount) {
+        memset(&lightsData[previousCount], 0, sizeof(LightData) * (lightsData.size() - previousCount));
+    }
+
+    shadowLights.clear();
     for (int i = 0; i < (int)lights.size(); i++) {
-        //TODO update only changed lights
+        // a moved or turned light has to re-render its shadow map
+        if (lightsData[i].position != lights[i]->position || lightsData[i].attenuation.r != lights[i]->radius ||
+            lightsData[i].direction_angle != lights[i]->direction_angle) {
+            lights[i]->needUpdate = true;
+        }
         lightsData[i].position = lights[i]->position;
         lightsData[i].color = lights[i]->color;
         lightsData[i].attenuation.r = lights[i]->radius; // radius
@@ -56,19 +71,43 @@ void Lighting::update() {
                 4 * lightsData[i].attenuation[1] * lightsData[i].attenuation[1]; // quadratic attenuation
 
         lightsData[i].direction_angle = lights[i]->direction_angle;
-        recalcVP(i);
+        if (lights[i]->needUpdate) {
+            recalcVP(i);
+        }
 
+        if (lights[i]->castShadows) {
+            shadowLights.push_back(i);
+        }
     }
 
+    upload();
+}
 
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightData) * MAX_LIGHTS, lightsData);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+void Lighting::upload() {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+    if (lightsData.size() > capacity_) {
+        while (capacity_ < lightsData.size()) {
+            capacity_ *= 2;
+        }
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(LightData) * capacity_, 0, GL_DYNAMIC_DRAW);
+    }
+    if (!lightsData.empty()) {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(LightData) * lightsData.size(), lightsData.data());
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
 }
 
 void Lighting::recalcVP(int idx) {
-    //TODO: recalc only changed lights
+    if (hasSpotShadow(lightsData[idx])) {
+        // the frustum covers the cone with a small margin, so the falloff at the edge stays inside the map
+        glm::vec3 direction = glm::vec3(lights[idx]->direction_angle);
+        glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::mat4 spotProj = glm::perspective(glm::radians(lights[idx]->direction_angle.w + 2.0f), 1.0f,
+                                              lights[idx]->near_plane, lights[idx]->radius);
+        lightsData[idx].vp[0] = spotProj * glm::lookAt(lights[idx]->position, lights[idx]->position + direction, up);
+        return;
+    }
     glm::mat4 shadowProj = glm::perspective(glm::radians(90.0f), 1.0f, lights[idx]->near_plane, lights[idx]->radius);
     lightsData[idx].vp[0] = shadowProj *
                             glm::lookAt(lights[idx]->position, lights[idx]->position + glm::vec3(1.0f, 0.0f, 0.0f),
@@ -91,16 +130,20 @@ void Lighting::recalcVP(int idx) {
 }
 
 void Lighting::draw(Shader &shader) {
+    Uniform<glm::mat4> model = shader.uniform<glm::mat4>("model");
+    Uniform<int> objectID = shader.uniform<int>("objectID");
+    GLState &state = GLState::instance();
+    state.enable(GL_STENCIL_TEST);
+    state.stencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
     for (auto &light: lights) {
-        shader.uniformMatrix("model", glm::scale(glm::translate(glm::mat4(1.0f), light->position), glm::vec3(0.04f)));
+        shader.set(model, glm::scale(glm::translate(glm::mat4(1.0f), light->position), glm::vec3(0.04f)));
 
-        glEnable(GL_STENCIL_TEST);
-        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-        glStencilFunc(GL_ALWAYS, light->ID, -1);
+        shader.set(objectID, (int) light->ID);
+        state.stencilFunc(GL_ALWAYS, light->ID, -1);
         light->draw(shader);
-        glStencilFunc(GL_ALWAYS, 0, -1);
-        glDisable(GL_STENCIL_TEST);
     }
+    state.stencilFunc(GL_ALWAYS, 0, -1);
+    state.disable(GL_STENCIL_TEST);
 }
 
 float Lighting::getRandomColor() {
@@ -111,11 +154,6 @@ float Lighting::getRandomColor() {
 }
 
 void Lighting::add(const LightPtr &light) {
-    if (lights.size() >= MAX_LIGHTS) {
-        std::cout << "\nMax lights count reached\n" << std::endl;
-        return;
-    }
-
     lights.push_back(light);
     update();
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #ifndef PROJECT_LIGHTING_H
 #define PROJECT_LIGHTING_H
 
+#include <cstddef>
 #include <vector>
 #include "Light.h"
 #include "glm/ext/matrix_float4x4.hpp"
@@ -25,31 +26,57 @@ struct Sun {
 };
 
 /// @struct LightData
-/// @brief Contains the data for a light source, used for uniform buffer objects.
-/// @details The structure includes position, color, attenuation, direction/angle, and view-projection matrices.
+/// @brief Contains the data for a light source, used for the light storage buffer.
+/// @details The structure includes position, color, attenuation, direction/angle, the shadow atlas tiles, and
+/// view-projection matrices. It mirrors the std430 LightData struct of res/lightData.glsl.
 struct LightData {
     alignas(16) glm::vec3 position; ///< The position of the light.
     alignas(16) glm::vec3 color; ///< The color of the light.
     alignas(16) glm::vec3 attenuation; ///< The attenuation factors of the light.
+    float shadowTileSize; ///< The size of the shadow atlas tiles relative to the atlas, 0 if the light has no shadow.
     alignas(16) glm::vec4 direction_angle; ///< The direction and angle of the light.
+    alignas(16) glm::vec4 shadowTiles[3]; ///< The relative corners of the tiles of the faces, two faces per vector.
     alignas(16) glm::mat4 vp[6]; ///< The view-projection matrices for the light.
 };
 
-#define MAX_LIGHTS 10 ///< The maximum number of lights supported.
+// the std430 offsets of res/lightData.glsl
+static_assert(offsetof(LightData, position) == 0);
+static_assert(offsetof(LightData, color) == 16);
+static_assert(offsetof(LightData, attenuation) == 32);
+static_assert(offsetof(LightData, shadowTileSize) == 44);
+static_assert(offsetof(LightData, direction_angle) == 48);
+static_assert(offsetof(LightData, shadowTiles) == 64);
+static_assert(offsetof(LightData, vp) == 112);
+static_assert(sizeof(LightData) == 496);
+
+#define LIGHTS_INITIAL_CAPACITY 16 ///< The number of lights the storage buffer is first allocated for.
+// the same value is defined in res/lightData.glsl
+#define SPOT_SHADOW_MAX_ANGLE 120.0f ///< Narrower lights get a single perspective shadow map instead of a cube.
+
+/// @brief Checks whether a light is rendered with a single perspective shadow map.
+/// @param data The data of the light.
+/// @return True for spot lights with a cone narrower than SPOT_SHADOW_MAX_ANGLE.
+inline bool hasSpotShadow(const LightData &data) {
+    return data.direction_angle.w < SPOT_SHADOW_MAX_ANGLE;
+}
 
 /// @class Lighting
 /// @brief The Lighting class manages multiple light sources and their data.
-/// @details This class handles the creation and management of lights, updating their data, and managing uniform buffer objects.
+/// @details This class handles the creation and management of lights, updating their data, and managing the light
+/// storage buffer. The buffer grows with the number of lights.
 class Lighting {
 public:
     /// @brief A vector of light pointers representing the light sources.
     std::vector<LightPtr> lights;
 
-    /// @brief An array of light data for use with uniform buffer objects.
-    LightData lightsData[MAX_LIGHTS];
+    /// @brief The data of every light, uploaded to the storage buffer.
+    std::vector<LightData> lightsData;
 
-    /// @brief The uniform buffer object (UBO) for the lights.
-    unsigned int ubo;
+    /// @brief The indices of the lights casting shadows, the renderer decides which of them fit the shadow atlas.
+    std::vector<size_t> shadowLights;
+
+    /// @brief The shader storage buffer object (SSBO) for the lights.
+    unsigned int ssbo;
 
     /// @brief The sun in the scene.
     Sun sun;
@@ -60,8 +87,8 @@ public:
     /// @brief Constructs a Lighting object and initializes the lighting system.
     Lighting();
 
-    /// @brief Creates the uniform buffer object for the lights.
-    void createUBO();
+    /// @brief Creates the shader storage buffer object for the lights.
+    void createSSBO();
 
     /// @brief Adds a point light to the scene.
     /// @param ID The unique identifier for the light.
@@ -77,9 +104,15 @@ public:
     void addSpotLight(size_t ID, glm::vec3 position, glm::vec3 color, glm::vec4 direction_angle);
 
     /// @brief Updates the lighting data.
+    /// @details Collects the lights casting shadows and uploads the data.
     void update();
 
+    /// @brief Uploads the light data, growing the storage buffer if it is too small.
+    void upload();
+
     /// @brief Recalculates the view-projection matrices for a specific light.
+    /// @details Point lights get the six 90 degree faces of a cube, spot lights a single frustum covering their cone
+    /// in vp[0].
     /// @param idx The index of the light to update.
     void recalcVP(int idx);
 
@@ -92,6 +125,9 @@ public:
     float getRandomColor();
 
 private:
+    /// @brief The number of lights the storage buffer is allocated for.
+    size_t capacity_ = 0;
+
     /// @brief Adds a light to the internal vector of lights.
     /// @param light The light pointer to be added.
     void add(const LightPtr &light);
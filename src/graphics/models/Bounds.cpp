@@ -0,0 +1,83 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+#include "Bounds.h"
+
+void Bounds::expand(const glm::vec3 &point) {
+    if (empty) {
+        min = point;
+        max = point;
+        empty = false;
+        return;
+    }
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void Bounds::expand(const Bounds &other) {
+    if (other.empty) {
+        return;
+    }
+    expand(other.min);
+    expand(other.max);
+}
+
+void Bounds::updateSphere() {
+    center = (min + max) * 0.5f;
+    radius = glm::length(max - center);
+}
+
+Bounds Bounds::transformed(const glm::mat4 &matrix) const {
+    if (empty) {
+        return *this;
+    }
+    // the extents of the new box are the extents of the old one projected on the absolute axes of the matrix
+    glm::vec3 localCenter = (min + max) * 0.5f;
+    glm::vec3 localExtents = max - localCenter;
+    glm::vec3 worldCenter = glm::vec3(matrix * glm::vec4(localCenter, 1.0f));
+    glm::vec3 worldExtents(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        worldExtents += glm::abs(glm::vec3(matrix[axis])) * localExtents[axis];
+    }
+
+    Bounds result;
+    result.min = worldCenter - worldExtents;
+    result.max = worldCenter + worldExtents;
+    result.empty = false;
+    result.updateSphere();
+
+    // the transformed sphere may be tighter than the sphere around the new box
+    float scale = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        scale = glm::max(scale, glm::length(glm::vec3(matrix[axis])));
+    }
+    glm::vec3 sphereCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+    if (radius * scale < result.radius) {
+        result.center = sphereCenter;
+        result.radius = radius * scale;
+    }
+    return result;
+}
+
+bool Bounds::intersectRay(const glm::vec3 &origin, const glm::vec3 &inverseDirection, float maxDistance,
+                          float &distance) const {
+    if (empty) {
+        return false;
+    }
+    // slab test, an axis parallel to the ray gives infinite distances that drop out of the min and max
+    glm::vec3 t0 = (min - origin) * inverseDirection;
+    glm::vec3 t1 = (max - origin) * inverseDirection;
+    glm::vec3 near = glm::min(t0, t1);
+    glm::vec3 far = glm::max(t0, t1);
+    float enter = glm::max(glm::max(near.x, near.y), glm::max(near.z, 0.0f));
+    float exit = glm::min(glm::min(far.x, far.y), glm::min(far.z, maxDistance));
+    if (enter > exit) {
+        return false;
+    }
+    distance = enter;
+    return true;
+}
@@ -0,0 +1,47 @@
+/// @file Bounds.h
+/// @brief This file contains the definition of the Bounds structure.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_BOUNDS_H
+#define PROJECT_BOUNDS_H
+
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+
+/// @struct Bounds
+/// @brief An axis-aligned bounding box together with a bounding sphere.
+struct Bounds {
+    glm::vec3 min = glm::vec3(0.0f); ///< The minimum corner of the box.
+    glm::vec3 max = glm::vec3(0.0f); ///< The maximum corner of the box.
+    glm::vec3 center = glm::vec3(0.0f); ///< The center of the sphere.
+    float radius = 0.0f; ///< The radius of the sphere.
+    bool empty = true; ///< Flag indicating whether the bounds contain no points.
+
+    /// @brief Extends the box by a point. The sphere is not updated, call updateSphere() afterwards.
+    /// @param point The point to add.
+    void expand(const glm::vec3 &point);
+
+    /// @brief Extends the box by another box. The sphere is not updated, call updateSphere() afterwards.
+    /// @param other The bounds to add.
+    void expand(const Bounds &other);
+
+    /// @brief Sets the sphere to the sphere around the box.
+    void updateSphere();
+
+    /// @brief Gets the bounds of the box transformed by a matrix.
+    /// @param matrix The affine transformation.
+    /// @return The axis-aligned box around the transformed box with its sphere.
+    Bounds transformed(const glm::mat4 &matrix) const;
+
+    /// @brief Intersects the box with a ray.
+    /// @param origin The origin of the ray.
+    /// @param inverseDirection The component-wise inverse of the direction of the ray.
+    /// @param maxDistance The distance along the ray beyond which hits are ignored.
+    /// @param distance Receives the distance at which the ray enters the box, 0 if it starts inside.
+    /// @return True if the ray hits the box within maxDistance.
+    bool intersectRay(const glm::vec3 &origin, const glm::vec3 &inverseDirection, float maxDistance,
+                      float &distance) const;
+};
+
+#endif //PROJECT_BOUNDS_H
@@ -0,0 +1,85 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "GL/glew.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "MaterialRegistry.h"
+#include "Mesh.h"
+#include "../GLState.h"
+
+MaterialRegistry &MaterialRegistry::instance() {
+    static MaterialRegistry instance;
+    return instance;
+}
+
+MaterialRegistry::MaterialRegistry() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    auto align = (size_t) std::max(alignment, 1);
+    stride_ = (sizeof(MaterialData) + align - 1) / align * align;
+    glGenBuffers(1, &ubo_);
+}
+
+unsigned int MaterialRegistry::add(const std::vector<TexturePtr> &textures, const Materials &materials) {
+    Material material{};
+    for (auto &texture: textures) {
+        if (texture->type == "texture_diffuse" && material.diffuse == 0) {
+            material.diffuse = texture->id;
+        } else if (texture->type == "texture_specular" && material.specular == 0) {
+            material.specular = texture->id;
+        }
+    }
+
+    // textures are keyed by their GL names, a name reused after a texture was deleted names the new texture
+    Key key = {{material.diffuse, material.specular},
+               {materials.diffuse.r, materials.diffuse.g, materials.diffuse.b, materials.diffuse.a,
+                materials.specular.r, materials.specular.g, materials.specular.b, materials.specular.a,
+                materials.shininess}};
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    material.data.diffuse = materials.diffuse;
+    material.data.specular = materials.specular;
+    material.data.shininess = materials.shininess;
+    material.data.useDiffTexture = material.diffuse != 0;
+    material.data.useSpecTexture = material.specular != 0;
+    materials_.push_back(material);
+    auto ID = (unsigned int) materials_.size();
+    index_.emplace(key, ID);
+    return ID;
+}
+
+void MaterialRegistry::upload() {
+    std::vector<unsigned char> data(stride_ * materials_.size());
+    for (size_t i = 0; i < materials_.size(); i++) {
+        std::memcpy(data.data() + stride_ * i, &materials_[i].data, sizeof(MaterialData));
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr) data.size(), data.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    uploaded_ = materials_.size();
+}
+
+void MaterialRegistry::bind(unsigned int ID) {
+    if (ID == 0 || ID > materials_.size()) {
+        return;
+    }
+    if (uploaded_ != materials_.size()) {
+        upload();
+    }
+    const Material &material = materials_[ID - 1];
+    glBindBufferRange(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, ubo_, (GLintptr) (stride_ * (ID - 1)),
+                      sizeof(MaterialData));
+    GLState &state = GLState::instance();
+    state.activeTexture(GL_TEXTURE0 + MATERIAL_UNIT_DIFFUSE);
+    state.bindTexture(GL_TEXTURE_2D, material.diffuse);
+    state.activeTexture(GL_TEXTURE0 + MATERIAL_UNIT_SPECULAR);
+    state.bindTexture(GL_TEXTURE_2D, material.specular);
+    state.activeTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,92 @@
+/// @file MaterialRegistry.h
+/// @brief This file contains the definition of the MaterialData structure and the MaterialRegistry class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_MATERIALREGISTRY_H
+#define PROJECT_MATERIALREGISTRY_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "glm/vec4.hpp"
+#include "../Texture.h"
+
+#define MATERIAL_BLOCK_BINDING 1 ///< The uniform block binding of the material parameters.
+#define MATERIAL_UNIT_DIFFUSE 0 ///< The texture unit of the diffuse texture.
+#define MATERIAL_UNIT_SPECULAR 1 ///< The texture unit of the specular texture.
+
+struct Materials;
+
+/// @struct MaterialData
+/// @brief The parameters of a material, laid out as the MaterialBlock of res/materialData.glsl (std140).
+struct MaterialData {
+    glm::vec4 diffuse; ///< The diffuse color.
+    glm::vec4 specular; ///< The specular color.
+    float shininess; ///< The shininess coefficient.
+    int32_t useDiffTexture; ///< Non-zero if the material has a diffuse texture.
+    int32_t useSpecTexture; ///< Non-zero if the material has a specular texture.
+    int32_t padding; ///< Padding to the 16 byte size of the block.
+};
+
+static_assert(sizeof(MaterialData) == 48, "MaterialData must match the std140 layout of res/materialData.glsl");
+
+/// @class MaterialRegistry
+/// @brief The MaterialRegistry class holds every distinct material of the loaded meshes.
+/// @details Meshes with the same textures and values share one material, registered when the mesh is loaded. The
+/// parameters of all materials are stored in one uniform buffer, and the textures use fixed units, so binding a
+/// material is one glBindBufferRange and two texture binds, without any uniform names. The registry lives as long as
+/// the GL context.
+class MaterialRegistry {
+public:
+    /// @brief Gets the registry, created on first use.
+    /// @return Reference to the registry.
+    static MaterialRegistry &instance();
+
+    /// @brief Gets the ID of a material, registering it if it is new.
+    /// @param textures The textures of the material, the first diffuse and specular ones are used.
+    /// @param materials The values of the material.
+    /// @return The ID of the material, never 0.
+    unsigned int add(const std::vector<TexturePtr> &textures, const Materials &materials);
+
+    /// @brief Binds the parameters and textures of a material.
+    /// @param ID The ID of the material, 0 binds nothing.
+    void bind(unsigned int ID);
+
+private:
+    /// @struct Material
+    /// @brief A registered material.
+    struct Material {
+        MaterialData data; ///< The parameters.
+        unsigned int diffuse; ///< The ID of the diffuse texture, 0 if there is none.
+        unsigned int specular; ///< The ID of the specular texture, 0 if there is none.
+    };
+
+    /// @brief The textures and values identifying a material.
+    using Key = std::pair<std::array<unsigned int, 2>, std::array<float, 9>>;
+
+    /// @brief The ID of every material by its key.
+    std::map<Key, unsigned int> index_;
+
+    /// @brief The materials, the one with ID i is at i - 1.
+    std::vector<Material> materials_;
+
+    /// @brief The ID of the uniform buffer with the parameters of all materials.
+    unsigned int ubo_ = 0;
+
+    /// @brief The distance between the parameters of two materials in the buffer.
+    size_t stride_ = 0;
+
+    /// @brief The number of materials in the buffer.
+    size_t uploaded_ = 0;
+
+    /// @brief Creates the uniform buffer.
+    MaterialRegistry();
+
+    /// @brief Uploads the parameters of all materials, called when materials were added since the last upload.
+    void upload();
+};
+
+#endif //PROJECT_MATERIALREGISTRY_H
@@ -15,6 +15,9 @@
 
 #include "../Shader.h"
 #include "../Texture.h"
+#include "Bounds.h"
+#include "MeshBVH.h"
+#include "MeshPool.h"
 
 #define HYPNOSIS 6
 #define HYPNOSIS_FRAME 24
@@ -22,6 +25,7 @@
 #define FRAMES_ROW 7
 #define FRAMES_COLUMN 7
 #define FRAMES_PERIOD_SEC 2.0f
+#define HYPNOSIS_SPEED 6.0f ///< The rotation speed of the hypnosis channel in degrees per second.
 
 
 class Mesh;
@@ -76,9 +80,22 @@ public:
     /// @brief Flag indicating whether the mesh has a specular texture.
     bool hasSpecTexture = false;
 
-    /// @brief The Vertex Array Object (VAO) for the mesh.
+    /// @brief The Vertex Array Object (VAO) for the mesh, the one of the mesh pool for meshes with indices.
     unsigned int vao;
 
+    /// @brief The range of the mesh in the mesh pool, unused by UI meshes.
+    MeshRange range;
+
+    /// @brief The bounds of the mesh in model space.
+    Bounds bounds;
+
+    /// @brief The tree over the triangles for ray queries in model space, empty for UI meshes.
+    MeshBVH bvh;
+
+    /// @brief The ID of the material in the MaterialRegistry, shared by all meshes with the same textures and material
+    /// values, 0 for UI meshes.
+    unsigned int materialID = 0;
+
     /// @brief Constructs a Mesh object with the specified vertices, indices, textures, and materials.
     /// @param vertices A vector of VertexType representing the vertices of the mesh.
     /// @param indices A vector of unsigned integers representing the indices of the mesh.
@@ -96,13 +113,21 @@ public:
     ~Mesh();
 
     /// @brief Draws the mesh using the specified shader.
-    /// @param shader The shader program used for rendering.
+    /// @param shader The shader program used for rendering, it reads the material from its block and texture units.
     void draw(Shader &shader);
 
+    /// @brief Binds the material of the mesh.
+    void bindMaterial() const;
+
+    /// @brief Draws the elements of the mesh with the currently bound material.
+    /// @param instances The number of instances to draw.
+    void drawElements(int instances = 1);
+
     /// @brief Draws the mesh as a TV screen with the specified channel ID.
     /// @param shader The shader program used for rendering.
     /// @param channelID The ID of the TV channel.
-    void drawTvScreen(Shader &shader, int channelID);
+    /// @param time The time the animation has been running for, in seconds.
+    void drawTvScreen(Shader &shader, int channelID, double time);
 
     /// @brief Draws the mesh as a UI element.
     void drawUi();
@@ -113,13 +138,10 @@ public:
     void reload(const float *buffer, size_t vertices);
 
 private:
-    /// @brief The Vertex Buffer Object (VBO) for the mesh.
-    unsigned int vbo_;
-
-    /// @brief The Element Buffer Object (EBO) for the mesh.
-    unsigned int ebo_;
+    /// @brief The Vertex Buffer Object (VBO) of a UI mesh.
+    unsigned int vbo_ = 0;
 
-    /// @brief Initializes the mesh by setting up the VAO, VBO, and EBO.
+    /// @brief Initializes the mesh by copying its vertices and indices into the mesh pool.
     void init();
 };
 
@@ -0,0 +1,234 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+#include "MeshBVH.h"
+#include "Bounds.h"
+#include "Mesh.h"
+
+// half the surface area of a box, the SAH only compares ratios
+static float halfArea(const Bounds &bounds) {
+    if (bounds.empty) {
+        return 0.0f;
+    }
+    glm::vec3 size = bounds.max - bounds.min;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+// slab test of a node, see Bounds::intersectRay
+static bool intersectBox(const glm::vec3 &min, const glm::vec3 &max, const glm::vec3 &origin,
+                         const glm::vec3 &inverseDirection, float maxDistance, float &distance) {
+    glm::vec3 t0 = (min - origin) * inverseDirection;
+    glm::vec3 t1 = (max - origin) * inverseDirection;
+    glm::vec3 near = glm::min(t0, t1);
+    glm::vec3 far = glm::max(t0, t1);
+    float enter = glm::max(glm::max(near.x, near.y), glm::max(near.z, 0.0f));
+    float exit = glm::min(glm::min(far.x, far.y), glm::min(far.z, maxDistance));
+    distance = enter;
+    return enter <= exit;
+}
+
+void MeshBVH::build(const std::vector<VertexType> &vertices, const std::vector<unsigned int> &indices) {
+    nodes_.clear();
+    triangles_.clear();
+    corners_.clear();
+    size_t count = indices.size() / 3;
+    if (count == 0) {
+        return;
+    }
+
+    std::vector<Bounds> boxes(count);
+    std::vector<glm::vec3> centroids(count);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 a = vertices[indices[3 * i]].position;
+        glm::vec3 b = vertices[indices[3 * i + 1]].position;
+        glm::vec3 c = vertices[indices[3 * i + 2]].position;
+        boxes[i].expand(a);
+        boxes[i].expand(b);
+        boxes[i].expand(c);
+        centroids[i] = (a + b + c) / 3.0f;
+    }
+    triangles_.resize(count);
+    std::iota(triangles_.begin(), triangles_.end(), 0u);
+
+    // the children are appended behind all nodes created so far and split when the loop reaches them
+    nodes_.reserve(2 * count);
+    nodes_.push_back({glm::vec3(0.0f), 0, glm::vec3(0.0f), (uint32_t) count});
+    std::vector<uint32_t> depths = {0};
+    for (size_t n = 0; n < nodes_.size(); n++) {
+        uint32_t first = nodes_[n].first;
+        uint32_t triangleCount = nodes_[n].count;
+        Bounds box;
+        Bounds centroidBox;
+        for (uint32_t i = first; i < first + triangleCount; i++) {
+            box.expand(boxes[triangles_[i]]);
+            centroidBox.expand(centroids[triangles_[i]]);
+        }
+        nodes_[n].min = box.min;
+        nodes_[n].max = box.max;
+        // a deeper node would overflow the traversal stack, which holds one sibling per level
+        if (triangleCount <= MESH_BVH_LEAF_SIZE || depths[n] + 2 >= MESH_BVH_STACK) {
+            continue;
+        }
+
+        // the cheapest plane between the bins of the centroids on any axis
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        int bestBin = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = centroidBox.max[axis] - centroidBox.min[axis];
+            if (extent <= 0.0f) {
+                continue;
+            }
+            Bounds bins[MESH_BVH_BINS];
+            uint32_t binCounts[MESH_BVH_BINS] = {};
+            float scale = (float) MESH_BVH_BINS / extent;
+            for (uint32_t i = first; i < first + triangleCount; i++) {
+                auto bin = std::min((int) ((centroids[triangles_[i]][axis] - centroidBox.min[axis]) * scale),
+                                    MESH_BVH_BINS - 1);
+                bins[bin].expand(boxes[triangles_[i]]);
+                binCounts[bin]++;
+            }
+
+            float rightCosts[MESH_BVH_BINS] = {};
+            Bounds right;
+            uint32_t rightCount = 0;
+            for (int bin = MESH_BVH_BINS - 1; bin > 0; bin--) {
+                right.expand(bins[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin - 1] = halfArea(right) * (float) rightCount;
+            }
+            Bounds left;
+            uint32_t leftCount = 0;
+            for (int bin = 0; bin < MESH_BVH_BINS - 1; bin++) {
+                left.expand(bins[bin]);
+                leftCount += binCounts[bin];
+                float cost = halfArea(left) * (float) leftCount + rightCosts[bin];
+                if (leftCount > 0 && leftCount < triangleCount && cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        // a traversal step costs about as much as a triangle test
+        float area = halfArea(box);
+        if (bestAxis < 0 || (area > 0.0f && bestCost / area + 1.0f >= (float) triangleCount)) {
+            continue;
+        }
+
+        float minimum = centroidBox.min[bestAxis];
+        float scale = (float) MESH_BVH_BINS / (centroidBox.max[bestAxis] - minimum);
+        auto middle = std::partition(triangles_.begin() + first, triangles_.begin() + first + triangleCount,
+                                     [&](uint32_t triangle) {
+                                         auto bin = std::min((int) ((centroids[triangle][bestAxis] - minimum) * scale),
+                                                             MESH_BVH_BINS - 1);
+                                         return bin <= bestBin;
+                                     });
+        auto leftCount = (uint32_t) (middle - triangles_.begin()) - first;
+
+        auto child = (uint32_t) nodes_.size();
+        nodes_[n].first = child;
+        nodes_[n].count = 0;
+        nodes_.push_back({glm::vec3(0.0f), first, glm::vec3(0.0f), leftCount});
+        nodes_.push_back({glm::vec3(0.0f), first + leftCount, glm::vec3(0.0f), triangleCount - leftCount});
+        depths.push_back(depths[n] + 1);
+        depths.push_back(depths[n] + 1);
+    }
+    nodes_.shrink_to_fit();
+
+    corners_.reserve(3 * count);
+    for (uint32_t triangle: triangles_) {
+        for (int corner = 0; corner < 3; corner++) {
+            corners_.push_back(vertices[indices[3 * triangle + corner]].position);
+        }
+    }
+}
+
+bool MeshBVH::intersect(const glm::vec3 &origin, const glm::vec3 &direction, float &distance,
+                        uint32_t &triangle) const {
+    if (nodes_.empty()) {
+        return false;
+    }
+    glm::vec3 inverseDirection = 1.0f / direction;
+    float enter;
+    if (!intersectBox(nodes_[0].min, nodes_[0].max, origin, inverseDirection, distance, enter)) {
+        return false;
+    }
+
+    // the nodes waiting to be visited with the distance the ray enters them
+    struct Entry {
+        uint32_t node;
+        float enter;
+    };
+    Entry stack[MESH_BVH_STACK];
+    size_t size = 0;
+    stack[size++] = {0, enter};
+    bool hit = false;
+    while (size > 0) {
+        Entry entry = stack[--size];
+        if (entry.enter > distance) {
+            continue;
+        }
+        const Node &node = nodes_[entry.node];
+        if (node.count > 0) {
+            // Moller-Trumbore, both sides of the triangles are hit
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                const glm::vec3 &a = corners_[3 * i];
+                glm::vec3 edge1 = corners_[3 * i + 1] - a;
+                glm::vec3 edge2 = corners_[3 * i + 2] - a;
+                glm::vec3 p = glm::cross(direction, edge2);
+                float determinant = glm::dot(edge1, p);
+                if (determinant == 0.0f) {
+                    continue;
+                }
+                float inverse = 1.0f / determinant;
+                glm::vec3 s = origin - a;
+                float u = glm::dot(s, p) * inverse;
+                if (u < 0.0f || u > 1.0f) {
+                    continue;
+                }
+                glm::vec3 q = glm::cross(s, edge1);
+                float v = glm::dot(direction, q) * inverse;
+                if (v < 0.0f || u + v > 1.0f) {
+                    continue;
+                }
+                float t = glm::dot(edge2, q) * inverse;
+                if (t > 0.0f && t < distance) {
+                    distance = t;
+                    triangle = triangles_[i];
+                    hit = true;
+                }
+            }
+            continue;
+        }
+
+        // the nearer child is pushed last, so it is visited first and shrinks the distance for the other one
+        const Node &left = nodes_[node.first];
+        const Node &right = nodes_[node.first + 1];
+        float leftEnter;
+        float rightEnter;
+        bool leftHit = intersectBox(left.min, left.max, origin, inverseDirection, distance, leftEnter);
+        bool rightHit = intersectBox(right.min, right.max, origin, inverseDirection, distance, rightEnter);
+        if (leftHit && rightHit && leftEnter < rightEnter) {
+            stack[size++] = {node.first + 1, rightEnter};
+            stack[size++] = {node.first, leftEnter};
+        } else {
+            if (leftHit) {
+                stack[size++] = {node.first, leftEnter};
+            }
+            if (rightHit) {
+                stack[size++] = {node.first + 1, rightEnter};
+            }
+        }
+    }
+    return hit;
+}
@@ -0,0 +1,66 @@
+/// @file MeshBVH.h
+/// @brief This file contains the definition of the MeshBVH class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_MESHBVH_H
+#define PROJECT_MESHBVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/vec3.hpp"
+
+#define MESH_BVH_BINS 12 ///< The number of candidate split planes per axis of the SAH build.
+#define MESH_BVH_LEAF_SIZE 2 ///< The number of triangles a node is always a leaf with.
+#define MESH_BVH_STACK 64 ///< The depth of the traversal stack.
+
+struct VertexType;
+
+/// @class MeshBVH
+/// @brief The MeshBVH class is a bounding volume hierarchy over the triangles of a mesh for ray queries on the CPU.
+/// @details The tree is built once when the mesh is loaded with binned surface area heuristic splits, and its nodes are
+/// stored in one array with the two children of a node next to each other. The leaves reference the
+/// triangles in their order in the tree, and the corners of the triangles are copied in that order, so a query touches
+/// neither the vertices nor the indices of the mesh.
+class MeshBVH {
+public:
+    /// @brief Builds the tree over the triangles of a mesh, replacing the previous one.
+    /// @param vertices The vertices of the mesh.
+    /// @param indices The indices of the mesh, three per triangle.
+    void build(const std::vector<VertexType> &vertices, const std::vector<unsigned int> &indices);
+
+    /// @brief Finds the closest triangle hit by a ray in model space.
+    /// @param origin The origin of the ray.
+    /// @param direction The direction of the ray, distances are measured in its length.
+    /// @param distance The distance beyond which hits are ignored, receives the distance of the hit.
+    /// @param triangle Receives the index of the hit triangle in the indices of the mesh, divided by three.
+    /// @return True if a triangle was hit.
+    bool intersect(const glm::vec3 &origin, const glm::vec3 &direction, float &distance, uint32_t &triangle) const;
+
+    /// @brief Gets the number of nodes of the tree.
+    /// @return The number of nodes, 0 if the mesh has no triangles.
+    size_t nodeCount() const { return nodes_.size(); }
+
+private:
+    /// @struct Node
+    /// @brief A node of the tree, 32 bytes.
+    struct Node {
+        glm::vec3 min; ///< The minimum corner of the box around the triangles of the node.
+        uint32_t first; ///< The first triangle of a leaf, the left child of an inner node.
+        glm::vec3 max; ///< The maximum corner of the box.
+        uint32_t count; ///< The number of triangles of a leaf, 0 for an inner node.
+    };
+
+    /// @brief The nodes, the root first.
+    std::vector<Node> nodes_;
+
+    /// @brief The index of every triangle in the mesh, in the order of the leaves.
+    std::vector<uint32_t> triangles_;
+
+    /// @brief The three corners of every triangle, in the order of the leaves.
+    std::vector<glm::vec3> corners_;
+};
+
+#endif //PROJECT_MESHBVH_H
@@ -0,0 +1,171 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "GL/glew.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "MeshPool.h"
+#include "Mesh.h"
+#include "../GLState.h"
+
+MeshPool &MeshPool::instance() {
+    static MeshPool instance;
+    return instance;
+}
+
+MeshPool::MeshPool() {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ebo_);
+
+    vertices_.capacity = MESH_POOL_INITIAL_VERTICES;
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(VertexType) * vertices_.capacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    indices_.capacity = MESH_POOL_INITIAL_INDICES;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo_);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(unsigned int) * indices_.capacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    bindBuffers();
+}
+
+void MeshPool::bindBuffers() const {
+    GLState::instance().bindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+
+    // Vertex coordinates
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexType), (void *) 0);
+
+    // Normal coordinates
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexType), (void *) offsetof(VertexType, normal));
+
+    // Texture coordinates
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexType), (void *) offsetof(VertexType, tex_coords));
+
+    // vector of tangents
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexType), (void *) offsetof(VertexType, tangent));
+
+    // vector of bitangents
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexType), (void *) offsetof(VertexType, bitangent));
+
+    GLState::instance().bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+uint32_t MeshPool::Ranges::allocate(uint32_t count) {
+    for (auto it = holes.begin(); it != holes.end(); ++it) {
+        if (it->second >= count) {
+            uint32_t offset = it->first;
+            if (it->second == count) {
+                holes.erase(it);
+            } else {
+                it->first += count;
+                it->second -= count;
+            }
+            return offset;
+        }
+    }
+    uint32_t offset = end;
+    end += count;
+    return offset;
+}
+
+void MeshPool::Ranges::release(uint32_t offset, uint32_t count) {
+    auto next = std::lower_bound(holes.begin(), holes.end(), std::make_pair(offset, 0u));
+    if (next != holes.end() && offset + count == next->first) {
+        count += next->second;
+        next = holes.erase(next);
+    }
+    if (next != holes.begin() && std::prev(next)->first + std::prev(next)->second == offset) {
+        auto previous = std::prev(next);
+        offset = previous->first;
+        count += previous->second;
+        next = holes.erase(previous);
+    }
+    if (offset + count == end) {
+        end = offset;
+    } else {
+        holes.insert(next, {offset, count});
+    }
+}
+
+void MeshPool::grow(unsigned int &buffer, Ranges &ranges, uint32_t required, size_t elementSize) {
+    uint32_t capacity = ranges.capacity;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr) (elementSize * capacity), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr) (elementSize * ranges.end));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+
+    buffer = grown;
+    ranges.capacity = capacity;
+}
+
+MeshRange MeshPool::allocate(const std::vector<VertexType> &vertices, const std::vector<unsigned int> &indices) {
+    MeshRange range;
+    range.vertexCount = (uint32_t) vertices.size();
+    range.indexCount = (uint32_t) indices.size();
+    range.firstVertex = vertices_.allocate(range.vertexCount);
+    range.firstIndex = indices_.allocate(range.indexCount);
+
+    bool grown = false;
+    if (vertices_.end > vertices_.capacity) {
+        // the new range is at the end, the copy only covers the ranges before it
+        vertices_.end -= range.vertexCount;
+        grow(vbo_, vertices_, vertices_.end + range.vertexCount, sizeof(VertexType));
+        vertices_.end += range.vertexCount;
+        grown = true;
+    }
+    if (indices_.end > indices_.capacity) {
+        indices_.end -= range.indexCount;
+        grow(ebo_, indices_, indices_.end + range.indexCount, sizeof(unsigned int));
+        indices_.end += range.indexCount;
+        grown = true;
+    }
+    if (grown) {
+        bindBuffers();
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo_);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) (sizeof(VertexType) * range.firstVertex),
+                    (GLsizeiptr) (sizeof(VertexType) * range.vertexCount), vertices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo_);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr) (sizeof(unsigned int) * range.firstIndex),
+                    (GLsizeiptr) (sizeof(unsigned int) * range.indexCount), indices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return range;
+}
+
+void MeshPool::free(const MeshRange &range) {
+    if (range.indexCount == 0) {
+        return;
+    }
+    vertices_.release(range.firstVertex, range.vertexCount);
+    indices_.release(range.firstIndex, range.indexCount);
+}
+
+void MeshPool::draw(const MeshRange &range, int instances) {
+    GLState::instance().bindVertexArray(vao);
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei) range.indexCount, GL_UNSIGNED_INT,
+                                      (void *) (sizeof(unsigned int) * range.firstIndex), instances,
+                                      (GLint) range.firstVertex);
+}
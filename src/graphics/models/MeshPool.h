@@ -0,0 +1,114 @@
+/// @file MeshPool.h
+/// @brief This file contains the definition of the MeshRange structure and the MeshPool class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_MESHPOOL_H
+#define PROJECT_MESHPOOL_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#define MESH_POOL_INITIAL_VERTICES (1u << 16) ///< The vertex capacity the pool starts with.
+#define MESH_POOL_INITIAL_INDICES (1u << 18) ///< The index capacity the pool starts with.
+
+struct VertexType;
+
+/// @struct MeshRange
+/// @brief The place of a mesh in the shared buffers of the pool.
+struct MeshRange {
+    /// @brief The first vertex of the mesh, added to every index.
+    uint32_t firstVertex = 0;
+
+    /// @brief The number of vertices.
+    uint32_t vertexCount = 0;
+
+    /// @brief The first index of the mesh.
+    uint32_t firstIndex = 0;
+
+    /// @brief The number of indices, 0 if the range is not allocated.
+    uint32_t indexCount = 0;
+};
+
+/// @class MeshPool
+/// @brief The MeshPool class holds the vertices and indices of all static meshes in two shared buffers.
+/// @details All meshes use the VertexType format and a single vertex array object, so draws of different meshes
+/// only differ in their ranges and can be submitted together with glMultiDrawElementsIndirect. The indices are local
+/// to their mesh and offset by the base vertex of the draw. Freed ranges are reused first-fit, and the buffers double
+/// when they are full. The buffers live as long as the GL context.
+class MeshPool {
+public:
+    /// @brief The ID of the vertex array object of all pooled meshes.
+    unsigned int vao = 0;
+
+    /// @brief Gets the pool, created on first use.
+    /// @return Reference to the pool.
+    static MeshPool &instance();
+
+    /// @brief Copies a mesh into the pool.
+    /// @param vertices The vertices of the mesh.
+    /// @param indices The indices of the mesh, relative to its first vertex.
+    /// @return The range of the mesh.
+    MeshRange allocate(const std::vector<VertexType> &vertices, const std::vector<unsigned int> &indices);
+
+    /// @brief Returns the range of a mesh to the pool.
+    /// @param range The range to free.
+    void free(const MeshRange &range);
+
+    /// @brief Draws a mesh.
+    /// @param range The range of the mesh.
+    /// @param instances The number of instances to draw.
+    void draw(const MeshRange &range, int instances = 1);
+
+private:
+    /// @struct Ranges
+    /// @brief The used part of a buffer and its free holes, in elements.
+    struct Ranges {
+        /// @brief The number of elements the buffer can hold.
+        uint32_t capacity = 0;
+
+        /// @brief The end of the last allocated range.
+        uint32_t end = 0;
+
+        /// @brief The free ranges below the end as (offset, count), sorted by offset.
+        std::vector<std::pair<uint32_t, uint32_t>> holes;
+
+        /// @brief Finds room for a range, first in the holes, then at the end.
+        /// @param count The number of elements.
+        /// @return The offset of the range, it may reach past the capacity.
+        uint32_t allocate(uint32_t count);
+
+        /// @brief Frees a range, merging it with its neighbours.
+        /// @param offset The offset of the range.
+        /// @param count The number of elements.
+        void release(uint32_t offset, uint32_t count);
+    };
+
+    /// @brief The ID of the shared vertex buffer.
+    unsigned int vbo_ = 0;
+
+    /// @brief The ID of the shared index buffer.
+    unsigned int ebo_ = 0;
+
+    /// @brief The vertex ranges.
+    Ranges vertices_;
+
+    /// @brief The index ranges.
+    Ranges indices_;
+
+    /// @brief Creates the buffers and the vertex array object.
+    MeshPool();
+
+    /// @brief Grows a buffer to hold at least the given number of elements, keeping its content.
+    /// @param buffer The buffer, replaced by the new one.
+    /// @param ranges The ranges of the buffer, its capacity is updated.
+    /// @param required The number of elements needed.
+    /// @param elementSize The size of an element in bytes.
+    static void grow(unsigned int &buffer, Ranges &ranges, uint32_t required, size_t elementSize);
+
+    /// @brief Points the vertex array object at the current buffers.
+    void bindBuffers() const;
+};
+
+#endif //PROJECT_MESHPOOL_H
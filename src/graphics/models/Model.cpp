@@ -13,6 +13,7 @@ Model::Model(std::string const &path, size_t ID, bool copy) : ID(ID), path(path)
     if (!isCopy) {
         ModelLoader modelLoader;
         this->meshes = modelLoader.loadModel(path);
+        updateBounds();
         std::cout << "New model " << path << " was loaded from files!" << std::endl;
     }
 }
@@ -35,9 +36,8 @@ ModelPtr Model::copy(size_t ID) {
     copy->position = this->position;
     copy->quatRotation = this->quatRotation;
     copy->cameraDistance = this->cameraDistance;
-    copy->view = this->view;
-    copy->projection = this->projection;
     copy->meshes = this->meshes;
+    copy->bounds = this->bounds;
     copy->className = this->className;
     copy->scale = this->scale;
     return copy;
@@ -56,3 +56,20 @@ glm::mat4 Model::getModelMatrixQuat() {
     return translateMat * rotateMat * scaleMat;
 }
 
+
+void Model::updateBounds() {
+    bounds = Bounds();
+    for (auto &mesh: meshes) {
+        bounds.expand(mesh->bounds);
+    }
+    if (meshes.size() == 1) {
+        // keep the sphere fitted to the vertices
+        bounds = meshes[0]->bounds;
+    } else if (!bounds.empty) {
+        bounds.updateSphere();
+    }
+}
+
+Bounds Model::getWorldBounds() {
+    return bounds.transformed(getModelMatrixQuat());
+}
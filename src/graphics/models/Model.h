@@ -21,6 +21,15 @@
 #define LINEAR_INTERPOLATION true
 #define CATMULLROM_INTERPOLATION false
 
+/// @enum GeometryShader
+/// @brief Identifies the shader a model is drawn with in the geometry pass.
+enum GeometryShader {
+    GEOMETRY_SHADER_DEFAULT = 0,
+    GEOMETRY_SHADER_MOUNTAINS,
+    GEOMETRY_SHADER_OUTLINE,
+    GEOMETRY_SHADER_INSTANCED ///< The default shader drawing all copies of a mesh at once, picked by the renderer.
+};
+
 class Model;
 
 using ModelPtr = std::shared_ptr<Model>;
@@ -45,6 +54,9 @@ public:
     /// @brief A vector of meshes that make up the model.
     std::vector<MeshPtr> meshes;
 
+    /// @brief The bounds of all meshes in model space.
+    Bounds bounds;
+
     /// @brief Flag indicating whether the model is a copy.
     bool isCopy = false;
 
@@ -69,12 +81,6 @@ public:
     /// @brief The distance from the camera to the model.
     float cameraDistance = 0;
 
-    /// @brief The view matrix for the model.
-    glm::mat4 view = glm::mat4(1.0f);
-
-    /// @brief The projection matrix for the model.
-    glm::mat4 projection = glm::mat4(1.0f);
-
     /// @brief Flag indicating whether the model is in selection mode.
     bool selectionMode = false;
 
@@ -100,6 +106,18 @@ public:
     /// @brief Updates the model's state.
     virtual void update();
 
+    /// @brief Gets the shader the model is drawn with in the geometry pass.
+    /// @return The geometry shader of the model.
+    virtual GeometryShader geometryShader() const { return GEOMETRY_SHADER_DEFAULT; }
+
+    /// @brief Checks whether the model is skipped by the geometry pass.
+    /// @return True if the model is hidden, false otherwise.
+    virtual bool hidden() const { return false; }
+
+    /// @brief Checks whether draw() is overridden, so the meshes of the model can not be drawn one by one.
+    /// @return True if the model has to be drawn with draw(), false otherwise.
+    virtual bool hasCustomDraw() const { return false; }
+
     /// @brief Creates a copy of the model with a new ID.
     /// @param ID The unique identifier for the new model.
     /// @return A shared pointer to the new model.
@@ -113,6 +131,13 @@ public:
     /// @brief Gets the model matrix with the quaternion rotation applied.
     /// @return The model matrix.
     glm::mat4 getModelMatrixQuat();
+
+    /// @brief Recalculates the model space bounds from the bounds of the meshes.
+    void updateBounds();
+
+    /// @brief Gets the bounds of the model in world space.
+    /// @return The bounds, empty if the model has no meshes.
+    Bounds getWorldBounds();
 };
 
 #endif //PROJECT_MODEL_H
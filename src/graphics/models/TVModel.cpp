@@ -5,6 +5,7 @@
 #include "GL/glew.h"
 #include <iostream>
 #include "TVModel.h"
+#include "MaterialRegistry.h"
 #include "../../window/Events.h"
 #include "GLFW/glfw3.h"
 #include "../../hardcode/tv.h"
@@ -15,40 +16,27 @@ TVModel::TVModel(std::string const &path, size_t ID, bool copy) : Model(path, ID
                                                                   tvScreen("res/tv/tv_screen.obj", ID) {
     createBuffers();
     texture_ = std::make_shared<Texture>("res/tv/tv.001.png");
+    texture_->type = "texture_diffuse";
+    Materials materials = {"tv", glm::vec4(1.0f), glm::vec4(0.0f), 32.0f};
+    materialID_ = MaterialRegistry::instance().add({texture_}, materials);
 }
 
 void TVModel::createBuffers() {
-    // Create buffer objects/arrays
-    glGenVertexArrays(1, &vao_);
-    glGenBuffers(1, &vbo_);
-    glGenBuffers(1, &ebo_);
-
-    glBindVertexArray(vao_);
-
-    // Load data into vertex buffers
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, tv_n_attribs_per_vertex * tv_n_vertices * sizeof(float), &tv_vertices,
-                 GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, 3 * tv_n_triangles * sizeof(unsigned), &tv_triangles, GL_STATIC_DRAW);
-
-    // Vertex
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * tv_n_attribs_per_vertex,
-                          (void *) (0 * sizeof(float)));
-
-    // Normal
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * tv_n_attribs_per_vertex,
-                          (void *) (3 * sizeof(float)));
-
-    // Texture coordinates
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(float) * tv_n_attribs_per_vertex,
-                          (void *) (6 * sizeof(float)));
-
-    glBindVertexArray(0);
+    // the hardcoded mesh is the same for every TV, it is copied into the mesh pool once
+    static MeshRange range = [] {
+        std::vector<VertexType> vertices(tv_n_vertices);
+        for (int i = 0; i < tv_n_vertices; i++) {
+            const float *vertex = tv_vertices + i * tv_n_attribs_per_vertex;
+            vertices[i].position = glm::vec3(vertex[0], vertex[1], vertex[2]);
+            vertices[i].normal = glm::vec3(vertex[3], vertex[4], vertex[5]);
+            vertices[i].tex_coords = glm::vec2(vertex[6], vertex[7]);
+            vertices[i].tangent = glm::vec3(0.0f);
+            vertices[i].bitangent = glm::vec3(0.0f);
+        }
+        std::vector<unsigned int> indices(tv_triangles, tv_triangles + 3 * tv_n_triangles);
+        return MeshPool::instance().allocate(vertices, indices);
+    }();
+    range_ = range;
 }
 
 void TVModel::update() {
@@ -59,27 +47,14 @@ void TVModel::update() {
     tvScreen.position = position;
     tvScreen.quatRotation = quatRotation;
     tvScreen.cameraDistance = cameraDistance;
-    tvScreen.view = view;
-    tvScreen.projection = projection;
     tvScreen.scale = scale;
     calculateShadow = false; //TVModel cant work with shadows!
 }
 
 void TVModel::draw(Shader &shader) {
     shader.uniformMatrix("model", getModelMatrixQuat());
-    shader.uniformInt("texture_diffuse1", 0);
-    shader.uniformBool("useDiffTexture", GL_TRUE);
-    shader.uniformBool("useSpecTexture", GL_FALSE);
-    glActiveTexture(GL_TEXTURE0);
-
-    texture_->bind();
-    glBindVertexArray(vao_);
-
-    glDrawElements(GL_TRIANGLES, (GLsizei) tv_n_triangles * 3, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-
-    glActiveTexture(GL_TEXTURE0);
-    texture_->unbind();
+    MaterialRegistry::instance().bind(materialID_);
+    MeshPool::instance().draw(range_);
     tvScreen.draw(shader);
 }
 
@@ -27,6 +27,10 @@ public:
     /// @param shader The shader program used for rendering.
     void draw(Shader &shader) override;
 
+    /// @brief The TV model draws its own buffers and the screen, so it is always drawn as a whole.
+    /// @return True.
+    bool hasCustomDraw() const override { return true; }
+
     /// @brief Updates the TV model's state.
     void update() override;
 
@@ -36,19 +40,16 @@ public:
     bool isInside(glm::vec3 point);
 
 private:
-    /// @brief The Vertex Array Object (VAO) for the TV model.
-    unsigned int vao_;
-
-    /// @brief The Vertex Buffer Object (VBO) for the TV model.
-    unsigned int vbo_;
-
-    /// @brief The Element Buffer Object (EBO) for the TV model.
-    unsigned int ebo_;
+    /// @brief The range of the TV mesh in the mesh pool, shared by all TVs.
+    MeshRange range_;
 
     /// @brief The texture associated with the TV model.
     TexturePtr texture_;
 
-    /// @brief Creates the buffers for the TV model.
+    /// @brief The ID of the material of the TV body in the MaterialRegistry.
+    unsigned int materialID_ = 0;
+
+    /// @brief Puts the TV mesh into the mesh pool.
     void createBuffers();
 };
 
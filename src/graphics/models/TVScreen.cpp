@@ -5,6 +5,8 @@
 #include "TVScreen.h"
 #include "glm/ext/matrix_transform.hpp"
 
+double TVScreen::animationTime = 0.0;
+
 TVScreen::TVScreen(std::string const &path, size_t ID, bool copy) : Model(path, ID, copy) {
     meshes[0]->textures.push_back(std::make_shared<Texture>("res/tv/spritesheet(4).png"));
     meshes[0]->textures.push_back(std::make_shared<Texture>("res/tv/spritesheet(5).png"));
@@ -16,10 +18,9 @@ TVScreen::TVScreen(std::string const &path, size_t ID, bool copy) : Model(path,
 
 void TVScreen::draw(Shader &shader) {
     this->shader.use();
-    this->shader.uniformMatrix("projection", projection);
-    this->shader.uniformMatrix("view", view);
     this->shader.uniformMatrix("model", getModelMatrixQuat());
+    this->shader.uniformInt("objectID", (int) ID);
     for (auto &mesh: meshes) {
-        mesh->drawTvScreen(this->shader, channelID);
+        mesh->drawTvScreen(this->shader, channelID, animationTime);
     }
 }
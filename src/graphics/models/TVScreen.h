@@ -16,6 +16,9 @@ public:
     /// @brief The ID of the current channel being displayed on the TV screen.
     int channelID = 0;
 
+    /// @brief The time the TV animations have been running for, accumulated from the delta times of the scene.
+    static double animationTime;
+
     /// @brief Constructs a TVScreen object with the specified path and ID.
     /// @param path The file path to the TV screen model.
     /// @param ID The unique identifier for the TV screen model. Default is 0.
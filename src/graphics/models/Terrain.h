@@ -18,6 +18,10 @@ public:
     /// @param ID The unique identifier for the terrain model.
     /// @param originalObjectID The unique identifier for the original object. Default is 0.
     explicit Terrain(std::string const &path, size_t ID = 0, size_t originalObjectID = 0) : Model(path, ID, originalObjectID) {}
+
+    /// @brief Gets the shader the terrain is drawn with in the geometry pass.
+    /// @return GEOMETRY_SHADER_MOUNTAINS.
+    GeometryShader geometryShader() const override { return GEOMETRY_SHADER_MOUNTAINS; }
 };
 
 #endif //PROJECT_TERRAIN_H
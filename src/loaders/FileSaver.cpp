@@ -28,6 +28,10 @@ bool FileSaver::getStatus() {
     return file.is_open();
 }
 
+bool FileSaver::isEnd() {
+    return file.peek() == std::char_traits<char>::eof();
+}
+
 void FileSaver::saveToFile(glm::mat4 &matrix) {
     file.write(reinterpret_cast<char *>(&matrix), sizeof(glm::mat4));
     checkError();
@@ -53,6 +57,11 @@ void FileSaver::saveToFile(float value) {
     checkError();
 }
 
+void FileSaver::saveToFile(double value) {
+    file.write(reinterpret_cast<char *>(&value), sizeof(double));
+    checkError();
+}
+
 void FileSaver::saveToFile(bool value) {
     file.write(reinterpret_cast<char *>(&value), sizeof(bool));
     checkError();
@@ -105,6 +114,11 @@ void FileSaver::loadFromFile(float &value) {
     checkError();
 }
 
+void FileSaver::loadFromFile(double &value) {
+    file.read(reinterpret_cast<char *>(&value), sizeof(double));
+    checkError();
+}
+
 void FileSaver::loadFromFile(bool &value) {
     file.read(reinterpret_cast<char *>(&value), sizeof(bool));
     checkError();
@@ -36,6 +36,10 @@ public:
     /// @return True if the file stream is in a good state, false otherwise.
     bool getStatus();
 
+    /// @brief Checks whether the whole file has been read.
+    /// @return True if there is no more data to load, false otherwise.
+    bool isEnd();
+
     /// @brief Saves a 4x4 matrix to the file.
     /// @param matrix The matrix to save.
     void saveToFile(glm::mat4 &matrix);
@@ -56,6 +60,10 @@ public:
     /// @param value The value to save.
     void saveToFile(float value);
 
+    /// @brief Saves a double value to the file.
+    /// @param value The value to save.
+    void saveToFile(double value);
+
     /// @brief Saves a boolean value to the file.
     /// @param value The value to save.
     void saveToFile(bool value);
@@ -92,6 +100,10 @@ public:
     /// @param value The value to load.
     void loadFromFile(float &value);
 
+    /// @brief Loads a double value from the file.
+    /// @param value The value to load.
+    void loadFromFile(double &value);
+
     /// @brief Loads a boolean value from the file.
     /// @param value The value to load.
     void loadFromFile(bool &value);
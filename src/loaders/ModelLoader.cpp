@@ -2,12 +2,15 @@
 // Created by korikmat on 07.05.2024.
 //
 
+#include <algorithm>
 #include <iostream>
 #include "ModelLoader.h"
+#include "../benchmark/Profiler.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 
 std::vector<MeshPtr> ModelLoader::loadModel(std::string const &path) {
+    PROFILE_ZONE("ModelLoader::loadModel");
     Assimp::Importer importer;
     const aiScene *scene = importer.ReadFile(path,
                                              aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
@@ -94,13 +97,26 @@ MeshPtr ModelLoader::processMesh(aiMesh *mesh, const aiScene *scene) {
             indices.push_back(face.mIndices[j]);
     }
 
+    // Bounds, the sphere is centered in the box but fitted to the vertices
+    Bounds bounds;
+    for (auto &vertex: vertices) {
+        bounds.expand(vertex.position);
+    }
+    bounds.updateSphere();
+    bounds.radius = 0.0f;
+    for (auto &vertex: vertices) {
+        bounds.radius = std::max(bounds.radius, glm::length(vertex.position - bounds.center));
+    }
+
     // Materials
     std::vector<TexturePtr> textures;
     Materials materials = {};
 
     if (mesh->mMaterialIndex >= scene->mNumMaterials) {
         std::cerr << "No materials found in the mesh." << std::endl;
-        return std::make_shared<Mesh>(vertices, indices, textures, materials);
+        MeshPtr newMesh = std::make_shared<Mesh>(vertices, indices, textures, materials);
+        newMesh->bounds = bounds;
+        return newMesh;
     }
 
     aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
@@ -125,10 +141,7 @@ MeshPtr ModelLoader::processMesh(aiMesh *mesh, const aiScene *scene) {
     materials = loadMaterials(material);
 
     MeshPtr newMesh = std::make_shared<Mesh>(vertices, indices, textures, materials);
-    if (!diffuseMaps.empty())
-        newMesh->hasDiffTexture = true;
-    if (!specularMaps.empty())
-        newMesh->hasSpecTexture = true;
+    newMesh->bounds = bounds;
     return newMesh;
 }
 
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include "TextureLoader.h"
+#include "../graphics/GLState.h"
 #include "IL/il.h"
 
 bool TextureLoader::loadTexImage2D(const char *fileName, GLenum target) {
@@ -47,7 +48,7 @@ GLuint TextureLoader::createTexture(const char *fileName, int *width, int *heigh
     GLuint tex = 0;
     glGenTextures(1, &tex);
 
-    glBindTexture(GL_TEXTURE_2D, tex);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, tex);
 
     // set linear filtering
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR); // TODO: check if this is correct
@@ -57,7 +58,8 @@ GLuint TextureLoader::createTexture(const char *fileName, int *width, int *heigh
 
     // upload our image data to OpenGL
     if (!loadTexImage2D(fileName, GL_TEXTURE_2D)) {
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
+        GLState::instance().forgetTexture(tex);
         glDeleteTextures(1, &tex);
         return 0;
     }
@@ -68,7 +70,7 @@ GLuint TextureLoader::createTexture(const char *fileName, int *width, int *heigh
 //    if(mipmap)
     glGenerateMipmap(GL_TEXTURE_2D);
     // unbind the texture (just in case someone will mess up with texture calls later)
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLState::instance().bindTexture(GL_TEXTURE_2D, 0);
 //    CHECK_GL_ERROR();
     return tex;
 }
@@ -78,7 +80,7 @@ GLuint TextureLoader::createSkyBoxTexture(const std::vector<std::string> &facesP
     GLuint tex = 0;
     glGenTextures(1, &tex);
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
+    GLState::instance().bindTexture(GL_TEXTURE_CUBE_MAP, tex);
 
     // set linear filtering
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -90,7 +92,8 @@ GLuint TextureLoader::createSkyBoxTexture(const std::vector<std::string> &facesP
     // upload our image data to OpenGL
     for (size_t i = 0; i < facesPaths.size(); i++) {
         if (!loadTexImage2D(facesPaths[i].c_str(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i)) {
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            GLState::instance().bindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            GLState::instance().forgetTexture(tex);
             glDeleteTextures(1, &tex);
             return 0;
         }
@@ -102,7 +105,7 @@ GLuint TextureLoader::createSkyBoxTexture(const std::vector<std::string> &facesP
 //    if(mipmap)
 //        glGenerateMipmap(GL_TEXTURE_2D);
     // unbind the texture (just in case someone will mess up with texture calls later)
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLState::instance().bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 //    CHECK_GL_ERROR();
     return tex;
 }
@@ -5,45 +5,245 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
 
 #include "window/Window.h"
 #include "window/Events.h"
 #include "graphics/Shader.h"
 #include "graphics/Texture.h"
+#include "graphics/GLState.h"
 #include "window/Camera.h"
 #include "graphics/models/Model.h"
 #include "scene/Scene.h"
+#include "benchmark/Benchmark.h"
+#include "window/InputTrace.h"
+#include "benchmark/Profiler.h"
+#include "renderers/DynamicResolution.h"
 
-int fps = 0;
-void countFPS() {
-    static double previousTime = glfwGetTime();
-    static int frameCount = 0;
-    double currentTime = glfwGetTime();
-    frameCount++;
-    if (currentTime - previousTime >= 1.0) {
-        fps = frameCount;
-        frameCount = 0;
-        previousTime = currentTime;
-    }
-}
-
-int main() {
-
-    Window::initialize("My Engine");
-    Events::initialize();
-    std::string sceneNameBin = Window::openFileSelectionDialog();
-    Scene scene(sceneNameBin);
+#define HEADLESS_WIDTH 1280
+#define HEADLESS_HEIGHT 720
 
+void setupGLState() {
 //    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-    glEnable(GL_CULL_FACE);
+    GLState &state = GLState::instance();
+    state.enable(GL_CULL_FACE);
     // Enable anti-aliasing
 //    glEnable(GL_MULTISAMPLE);
-    glDisable((GL_MULTISAMPLE));
+    state.disable(GL_MULTISAMPLE);
     // Enable depth test
-    glEnable(GL_DEPTH_TEST);
+    state.enable(GL_DEPTH_TEST);
 //    glEnable(GL_BLEND);
 //    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+// parses a non-negative integer argument, false if it is not a number or larger than max
+static bool parseCount(const char *text, unsigned long max, unsigned long &value) {
+    // stoul skips spaces and accepts a sign, wrapping negative values around
+    if (!std::isdigit((unsigned char) text[0])) {
+        return false;
+    }
+    try {
+        size_t length;
+        value = std::stoul(text, &length);
+        return text[length] == '\0' && value <= max;
+    } catch (const std::logic_error &) {
+        return false;
+    }
+}
+
+// parses a finite non-negative number argument, false if it is not one
+static bool parseNumber(const char *text, float &value) {
+    try {
+        size_t length;
+        value = std::stof(text, &length);
+        return text[length] == '\0' && std::isfinite(value) && value >= 0.0f;
+    } catch (const std::logic_error &) {
+        return false;
+    }
+}
+
+static void printUsage(const char *program) {
+    std::cerr << "Usage: " << program << " [--scene file.bin] [--record trace.bin | --replay trace.bin] [--gpu-csv file.csv]"
+              << " [--profile trace.json] [--frame-stats summary.json] [--shadow-atlas texels] [--gbuffer-full]"
+              << " [--target-ms milliseconds]"
+              << " [--headless [--frames N] [--dt seconds]]" << std::endl;
+}
+
+// reads the whole file, empty if it can not be opened
+static std::string readFileBytes(const std::string &fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+// false if a replay or a benchmark run changed the scene file it ran against
+static bool checkSceneUnchanged(const std::string &sceneNameBin, const std::string &bytes) {
+    if (readFileBytes(sceneNameBin) == bytes) {
+        return true;
+    }
+    std::cerr << "The run modified the scene file " << sceneNameBin << std::endl;
+    return false;
+}
+
+// usage: project --headless --scene foo.bin [--frames N] [--dt seconds] [--replay trace.bin] [--gpu-csv foo.csv]
+//                [--frame-stats foo.json]
+int runHeadless(std::string sceneNameBin, size_t frames, float deltaTime, const std::string &replayName,
+                const std::string &gpuCsvName, const std::string &frameStatsName) {
+    std::unique_ptr<InputTrace> trace;
+    if (!replayName.empty()) {
+        trace = std::make_unique<InputTrace>(READ, replayName);
+        if (!trace->getStatus()) {
+            return -1;
+        }
+        Events::trace = trace.get();
+        if (sceneNameBin.empty()) {
+            sceneNameBin = Window::openFileSelectionDialog();
+        }
+    }
+    std::string sceneBytes = readFileBytes(sceneNameBin);
+
+    if (Window::initializeHeadless(HEADLESS_WIDTH, HEADLESS_HEIGHT) != 0) {
+        return -1;
+    }
+    Events::initialize();
+    {
+        Scene scene(sceneNameBin);
+        setupGLState();
+        if (!gpuCsvName.empty()) {
+            scene.renderer.passTimer.openCsv(gpuCsvName);
+        }
+
+        Benchmark benchmark(scene, frames, deltaTime, trace.get());
+        benchmark.run();
+        if (!frameStatsName.empty()) {
+            scene.frameStats.writeSummary(frameStatsName);
+        }
+        // the scene is not saved, benchmark runs must not modify the scene file
+    }
+    Events::trace = nullptr;
+    Window::destroy();
+    Window::terminate();
+    return checkSceneUnchanged(sceneNameBin, sceneBytes) ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    bool headless = false;
+    std::string sceneNameBin;
+    size_t frames = 0;
+    float fixedDeltaTime = 1.0f / 60.0f;
+    bool targetGiven = false;
+    std::string recordName, replayName, gpuCsvName, profileName, frameStatsName;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            sceneNameBin = argv[++i];
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            unsigned long count;
+            if (!parseCount(argv[++i], SIZE_MAX, count)) {
+                std::cerr << "Invalid number of frames: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            frames = count;
+        } else if (std::strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            if (!parseNumber(argv[++i], fixedDeltaTime) || fixedDeltaTime == 0.0f) {
+                std::cerr << "Invalid time step: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordName = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayName = argv[++i];
+        } else if (std::strcmp(argv[i], "--gpu-csv") == 0 && i + 1 < argc) {
+            gpuCsvName = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profileName = argv[++i];
+        } else if (std::strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc) {
+            frameStatsName = argv[++i];
+        } else if (std::strcmp(argv[i], "--gbuffer-full") == 0) {
+            gBuffer::compact = false;
+        } else if (std::strcmp(argv[i], "--target-ms") == 0 && i + 1 < argc) {
+            if (!parseNumber(argv[++i], DynamicResolution::defaultTarget)) {
+                std::cerr << "Invalid target frame time: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            targetGiven = true;
+        } else if (std::strcmp(argv[i], "--shadow-atlas") == 0 && i + 1 < argc) {
+            unsigned long size;
+            if (!parseCount(argv[++i], UINT32_MAX, size) || size < SHADOW_TILE_MIN * 4 || (size & (size - 1)) != 0) {
+                std::cerr << "The shadow atlas size must be a power of two of at least " << SHADOW_TILE_MIN * 4
+                          << std::endl;
+                printUsage(argv[0]);
+                return -1;
+            }
+            ShadowAtlas::defaultSize = (unsigned int) size;
+        } else {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+    if (!recordName.empty() && (headless || !replayName.empty())) {
+        // headless runs read no input and a replay feeds recorded input, there is nothing to record
+        std::cerr << "--record can not be combined with " << (headless ? "--headless" : "--replay") << std::endl;
+        printUsage(argv[0]);
+        return -1;
+    }
+    if (!profileName.empty()) {
+        Profiler::fileName = profileName;
+    }
+    if (!gBuffer::compact) {
+        Shader::defines += "#define GBUFFER_FULL\n";
+    }
+    if (headless) {
+        if (!targetGiven) {
+            // benchmark runs keep the full resolution, so every run renders the same number of pixels
+            DynamicResolution::defaultTarget = 0.0f;
+        }
+        if (frames == 0) {
+            // a replay runs to the end of the trace
+            frames = replayName.empty() ? 1000 : SIZE_MAX;
+        }
+        int result = runHeadless(sceneNameBin, frames, fixedDeltaTime, replayName, gpuCsvName, frameStatsName);
+        if (!profileName.empty()) {
+            Profiler::dump();
+        }
+        return result;
+    }
+
+    Window::initialize("My Engine");
+    Events::initialize();
+
+    std::unique_ptr<InputTrace> trace;
+    if (!recordName.empty() || !replayName.empty()) {
+        trace = recordName.empty() ? std::make_unique<InputTrace>(READ, replayName)
+                                   : std::make_unique<InputTrace>(WRITE, recordName);
+        if (trace->getStatus()) {
+            Events::trace = trace.get();
+        }
+    }
+    if (sceneNameBin.empty()) {
+        sceneNameBin = Window::openFileSelectionDialog();
+    }
+    bool replaying = Events::trace != nullptr && Events::trace->mode == READ;
+    std::string sceneBytes = replaying ? readFileBytes(sceneNameBin) : std::string();
+    Scene scene(sceneNameBin);
+    if (!gpuCsvName.empty()) {
+        scene.renderer.passTimer.openCsv(gpuCsvName);
+    }
+
+    setupGLState();
 
     double previousTime = glfwGetTime();
     float deltaTime;
@@ -51,16 +251,40 @@ int main() {
     while (!Window::isWindowShouldClose()) {
         double currentTime = glfwGetTime();
         deltaTime = (float) (currentTime - previousTime);
+        scene.frameStats.record(currentTime - previousTime);
         previousTime = currentTime;
 
-        countFPS();
+        if (Events::trace != nullptr) {
+            if (Events::trace->mode == WRITE) {
+                Events::trace->record(deltaTime);
+            } else if (!Events::trace->replay(deltaTime)) {
+                break;
+            }
+        }
+
         scene.update(deltaTime);
-        scene.draw(fps);
+        scene.draw();
 
     }
-    scene.saveScene();
+    scene.frameStats.printSummary();
+    if (!frameStatsName.empty()) {
+        scene.frameStats.writeSummary(frameStatsName);
+    }
+    if (Events::trace == nullptr) {
+        scene.saveScene();
+    } else {
+        // keep the starting scene intact, so the trace can be replayed against it
+        std::cout << "Input trace: " << Events::trace->framesCount << " frames, scene not saved" << std::endl;
+        Events::trace = nullptr;
+    }
     Window::destroy();
     Window::terminate();
 
+    if (!profileName.empty()) {
+        Profiler::dump();
+    }
+    if (replaying && !checkSceneUnchanged(sceneNameBin, sceneBytes)) {
+        return -1;
+    }
     return 0;
 }
@@ -0,0 +1,29 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "DynamicResolution.h"
+
+float DynamicResolution::defaultTarget = 1000.0f / 60.0f;
+
+void DynamicResolution::update(double frameTime) {
+    if (targetFrameTime <= 0.0f) {
+        scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+        return;
+    }
+    if (frameTime <= 0.0 || (frameTime <= targetFrameTime && frameTime >= targetFrameTime * DYNAMIC_RESOLUTION_HEADROOM)) {
+        return;
+    }
+
+    // the cost follows the area, the scale is per axis
+    auto desired = scale * (float) std::sqrt(targetFrameTime * DYNAMIC_RESOLUTION_HEADROOM / frameTime);
+    scale += (desired - scale) * DYNAMIC_RESOLUTION_DAMPING;
+    scale = std::clamp(scale, DYNAMIC_RESOLUTION_MIN_SCALE, DYNAMIC_RESOLUTION_MAX_SCALE);
+}
+
+int DynamicResolution::scaled(int size) const {
+    return std::max(1, (int) std::lround((float) size * scale));
+}
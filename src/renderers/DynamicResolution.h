@@ -0,0 +1,40 @@
+/// @file DynamicResolution.h
+/// @brief This file contains the definition of the DynamicResolution class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_DYNAMICRESOLUTION_H
+#define PROJECT_DYNAMICRESOLUTION_H
+
+#define DYNAMIC_RESOLUTION_MIN_SCALE 0.5f ///< The lowest scale of the internal resolution per axis.
+#define DYNAMIC_RESOLUTION_MAX_SCALE 1.0f ///< The highest scale of the internal resolution per axis.
+#define DYNAMIC_RESOLUTION_HEADROOM 0.85f ///< The scale only grows while the frame is this far under the target.
+#define DYNAMIC_RESOLUTION_DAMPING 0.1f ///< The fraction of the correction applied per frame.
+
+/// @class DynamicResolution
+/// @brief The DynamicResolution class picks the internal resolution of the deferred passes from the GPU frame time.
+/// @details The pixel cost of the geometry and lighting passes grows with the area, so the scale per axis moves
+/// towards sqrt(target / frame time). The correction is damped, and between the headroom and the target the scale
+/// is left alone, so it does not oscillate around the target.
+class DynamicResolution {
+public:
+    /// @brief The target GPU time of a frame used by new controllers in milliseconds, 0 disables the scaling.
+    static float defaultTarget;
+
+    /// @brief The target GPU time of a frame in milliseconds, 0 keeps the full resolution.
+    float targetFrameTime = defaultTarget;
+
+    /// @brief The current scale of the internal resolution per axis.
+    float scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+
+    /// @brief Adjusts the scale to the GPU time of the last resolved frame.
+    /// @param frameTime The GPU time of the frame in milliseconds, 0 if no frame was resolved.
+    void update(double frameTime);
+
+    /// @brief Scales a window dimension to the internal resolution.
+    /// @param size The window dimension in pixels.
+    /// @return The internal dimension, at least one pixel.
+    int scaled(int size) const;
+};
+
+#endif //PROJECT_DYNAMICRESOLUTION_H
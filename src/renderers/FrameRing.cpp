@@ -0,0 +1,122 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "GL/glew.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "FrameRing.h"
+
+FrameRing::FrameRing() {
+    GLint uniformAlignment = 0;
+    GLint storageAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+    alignment_ = (size_t) std::max({uniformAlignment, storageAlignment, 16});
+    create(FRAME_RING_INITIAL_SIZE);
+}
+
+FrameRing::~FrameRing() {
+    for (auto &fence: fences_) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+    destroy();
+}
+
+void FrameRing::create(size_t size) {
+    sectionSize = (size + alignment_ - 1) / alignment_ * alignment_;
+    auto bytes = (GLsizeiptr) (sectionSize * FRAME_RING_SECTIONS);
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, bytes, nullptr, flags);
+    mapped_ = (unsigned char *) glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bytes, flags);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (mapped_ == nullptr) {
+        std::cerr << "Failed to map the frame ring buffer of " << bytes << " bytes" << std::endl;
+    }
+}
+
+void FrameRing::destroy() {
+    if (buffer == 0) {
+        return;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    mapped_ = nullptr;
+}
+
+void FrameRing::wait(GLsync &fence) {
+    if (fence == nullptr) {
+        return;
+    }
+    // the first wait flushes the commands, so the fence is guaranteed to be signaled eventually
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+        GLenum result = glClientWaitSync(fence, flags, 1000000000);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            break;
+        }
+        if (result == GL_WAIT_FAILED) {
+            std::cerr << "Failed to wait for the frame ring fence" << std::endl;
+            break;
+        }
+        flags = 0;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void FrameRing::beginFrame(size_t required, size_t allocations) {
+    required += allocations * alignment_;
+    if (required > sectionSize) {
+        // the GPU may still read any section, the buffer is replaced once all of them are done
+        for (auto &fence: fences_) {
+            wait(fence);
+        }
+        destroy();
+        create(std::max(required, sectionSize * 2));
+    }
+    section_ = (section_ + 1) % FRAME_RING_SECTIONS;
+    wait(fences_[section_]);
+    offset_ = 0;
+}
+
+void *FrameRing::allocate(size_t size, size_t &offset) {
+    size_t start = (offset_ + alignment_ - 1) / alignment_ * alignment_;
+    if (mapped_ == nullptr || start + size > sectionSize) {
+        std::cerr << "The frame ring section is full, " << size << " bytes were not allocated" << std::endl;
+        return nullptr;
+    }
+    offset_ = start + size;
+    offset = section_ * sectionSize + start;
+    return mapped_ + offset;
+}
+
+void FrameRing::upload(unsigned int target, unsigned int binding, const void *data, size_t size) {
+    size_t offset;
+    void *memory = allocate(std::max(size, (size_t) 1), offset);
+    if (memory == nullptr) {
+        return;
+    }
+    if (size > 0) {
+        std::memcpy(memory, data, size);
+    }
+    glBindBufferRange(target, binding, buffer, (GLintptr) offset, (GLsizeiptr) std::max(size, (size_t) 1));
+}
+
+void FrameRing::endFrame() {
+    if (fences_[section_] != nullptr) {
+        glDeleteSync(fences_[section_]);
+    }
+    fences_[section_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
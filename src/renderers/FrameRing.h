@@ -0,0 +1,113 @@
+/// @file FrameRing.h
+/// @brief This file contains the definition of the FrameData structure and the FrameRing class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_FRAMERING_H
+#define PROJECT_FRAMERING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+#define FRAME_RING_SECTIONS 3 ///< The number of frames the ring holds, the GPU may still read the two before.
+#define FRAME_RING_INITIAL_SIZE (1u << 16) ///< The size of a section the ring starts with, in bytes.
+
+typedef struct __GLsync *GLsync;
+
+/// @struct FrameData
+/// @brief The constants of a frame, laid out as the FrameConstants block of res/frameData.glsl (std140).
+struct FrameData {
+    glm::mat4 view; ///< The view matrix of the active camera.
+    glm::mat4 projection; ///< The projection matrix of the active camera.
+    glm::mat4 viewProjection; ///< The product of the projection and the view matrix.
+    glm::mat4 inverseViewProjection; ///< The inverse of the view-projection matrix.
+    glm::vec4 viewPos; ///< The position of the camera.
+    glm::vec4 sunDirection; ///< The direction of the sun light.
+    glm::vec4 sunColor; ///< The color of the sun light.
+    glm::vec4 fogColor; ///< The color of the fog.
+    float fogDensity; ///< The density of the fog.
+    int32_t sunEnabled; ///< Non-zero if the sun is enabled.
+    int32_t fogEnabled; ///< Non-zero if the fog is enabled.
+    int32_t padding; ///< Padding to the 16 byte size of the block.
+};
+
+static_assert(sizeof(FrameData) == 336, "FrameData must match the std140 layout of res/frameData.glsl");
+
+/// @class FrameRing
+/// @brief The FrameRing class streams the data of every frame through one persistently mapped buffer.
+/// @details The buffer is split into FRAME_RING_SECTIONS sections and every frame writes into the next one, so the
+/// CPU never writes to memory the GPU may still read. A fence is placed after the commands of each frame and waited
+/// for before its section is reused. Within a frame the data is bump allocated at the offset alignment of uniform
+/// and shader storage buffers and bound with glBindBufferRange, the buffer is never orphaned or re-specified.
+class FrameRing {
+public:
+    /// @brief The ID of the buffer.
+    unsigned int buffer = 0;
+
+    /// @brief The size of a section in bytes.
+    size_t sectionSize = 0;
+
+    /// @brief Creates the buffer and maps it.
+    FrameRing();
+
+    /// @brief Unmaps and deletes the buffer.
+    ~FrameRing();
+
+    FrameRing(const FrameRing &) = delete;
+
+    FrameRing &operator=(const FrameRing &) = delete;
+
+    /// @brief Moves to the next section, waiting until the GPU has finished the frame that used it.
+    /// @details The buffer grows when a section is smaller than the frame needs.
+    /// @param required The number of bytes the frame writes.
+    /// @param allocations The number of allocations, each may lose up to one alignment to padding.
+    void beginFrame(size_t required, size_t allocations);
+
+    /// @brief Reserves memory in the section of the current frame.
+    /// @param size The number of bytes.
+    /// @param offset Receives the offset of the memory in the buffer.
+    /// @return The mapped memory, nullptr if the section is full.
+    void *allocate(size_t size, size_t &offset);
+
+    /// @brief Copies data into the section of the current frame and binds it to an indexed buffer target.
+    /// @param target GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+    /// @param binding The binding point.
+    /// @param data The data.
+    /// @param size The number of bytes, at least one byte is bound.
+    void upload(unsigned int target, unsigned int binding, const void *data, size_t size);
+
+    /// @brief Places the fence of the current frame after the commands submitted so far.
+    void endFrame();
+
+private:
+    /// @brief The persistently mapped memory of the whole buffer.
+    unsigned char *mapped_ = nullptr;
+
+    /// @brief The fence of the last frame written to every section, nullptr if there is none.
+    GLsync fences_[FRAME_RING_SECTIONS] = {};
+
+    /// @brief The section of the current frame.
+    size_t section_ = 0;
+
+    /// @brief The first free byte in the section of the current frame.
+    size_t offset_ = 0;
+
+    /// @brief The offset alignment of uniform and shader storage buffer bindings.
+    size_t alignment_ = 0;
+
+    /// @brief Creates and maps the buffer.
+    /// @param size The size of a section in bytes.
+    void create(size_t size);
+
+    /// @brief Unmaps and deletes the buffer.
+    void destroy();
+
+    /// @brief Waits until the GPU has passed a fence and deletes it.
+    /// @param fence The fence, reset to nullptr.
+    static void wait(GLsync &fence);
+};
+
+#endif //PROJECT_FRAMERING_H
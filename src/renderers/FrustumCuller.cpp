@@ -0,0 +1,203 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define FRUSTUM_CULLER_SSE
+#endif
+
+#include "glm/geometric.hpp"
+#include "glm/common.hpp"
+
+#include "FrustumCuller.h"
+#include "../graphics/models/Model.h"
+#include "../graphics/lighting/Lighting.h"
+#include "../benchmark/Profiler.h"
+
+Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection) {
+    // Gribb-Hartmann: every plane is the fourth row plus or minus one of the other rows
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++) {
+        row[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+    Frustum frustum{};
+    frustum.planes[0] = row[3] + row[0];
+    frustum.planes[1] = row[3] - row[0];
+    frustum.planes[2] = row[3] + row[1];
+    frustum.planes[3] = row[3] - row[1];
+    frustum.planes[4] = row[3] + row[2];
+    frustum.planes[5] = row[3] - row[2];
+    for (auto &plane: frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+    for (auto &plane: planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersectsBox(const Bounds &bounds) const {
+    glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+    glm::vec3 extents = bounds.max - center;
+    for (auto &plane: planes) {
+        glm::vec3 normal = glm::vec3(plane);
+        if (glm::dot(normal, center) + plane.w < -glm::dot(glm::abs(normal), extents)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrustumCuller::cull(std::span<Model *const> models, const glm::mat4 &viewProjection,
+                         std::vector<Model *> &visible) {
+    PROFILE_ZONE("FrustumCuller::cull");
+    if (!frozen) {
+        viewProjection_ = viewProjection;
+    }
+    Frustum frustum = Frustum::fromMatrix(viewProjection_);
+
+    visible.clear();
+    candidates_.clear();
+    centerX_.clear();
+    centerY_.clear();
+    centerZ_.clear();
+    extentX_.clear();
+    extentY_.clear();
+    extentZ_.clear();
+    for (Model *model: models) {
+        if (model->bounds.empty) {
+            visible.push_back(model);
+            continue;
+        }
+        Bounds bounds = model->getWorldBounds();
+        glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+        glm::vec3 extents = bounds.max - center;
+        candidates_.push_back(model);
+        centerX_.push_back(center.x);
+        centerY_.push_back(center.y);
+        centerZ_.push_back(center.z);
+        extentX_.push_back(extents.x);
+        extentY_.push_back(extents.y);
+        extentZ_.push_back(extents.z);
+    }
+
+    size_t count = candidates_.size();
+    size_t visibleBefore = visible.size();
+    size_t i = 0;
+#ifdef FRUSTUM_CULLER_SSE
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6], absX[6], absY[6], absZ[6];
+    for (int p = 0; p < 6; p++) {
+        const glm::vec4 &plane = frustum.planes[p];
+        planeX[p] = _mm_set1_ps(plane.x);
+        planeY[p] = _mm_set1_ps(plane.y);
+        planeZ[p] = _mm_set1_ps(plane.z);
+        planeW[p] = _mm_set1_ps(plane.w);
+        absX[p] = _mm_set1_ps(glm::abs(plane.x));
+        absY[p] = _mm_set1_ps(glm::abs(plane.y));
+        absZ[p] = _mm_set1_ps(glm::abs(plane.z));
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(&centerX_[i]);
+        __m128 cy = _mm_loadu_ps(&centerY_[i]);
+        __m128 cz = _mm_loadu_ps(&centerZ_[i]);
+        __m128 ex = _mm_loadu_ps(&extentX_[i]);
+        __m128 ey = _mm_loadu_ps(&extentY_[i]);
+        __m128 ez = _mm_loadu_ps(&extentZ_[i]);
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < 6; p++) {
+            // distance of the center to the plane plus the projected half size of the box
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)),
+                                         _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)),
+                                       _mm_mul_ps(absZ[p], ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(outside);
+        for (int lane = 0; lane < 4; lane++) {
+            if (!(mask & (1 << lane))) {
+                visible.push_back(candidates_[i + lane]);
+            }
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        bool inside = true;
+        for (auto &plane: frustum.planes) {
+            float distance = plane.x * centerX_[i] + plane.y * centerY_[i] + plane.z * centerZ_[i] + plane.w;
+            float radius = glm::abs(plane.x) * extentX_[i] + glm::abs(plane.y) * extentY_[i] +
+                           glm::abs(plane.z) * extentZ_[i];
+            if (distance + radius < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) {
+            visible.push_back(candidates_[i]);
+        }
+    }
+
+    tested = count;
+    culled = count - (visible.size() - visibleBefore);
+}
+
+void FrustumCuller::cullShadowCasters(std::span<Model *const> models, const LightData *lights,
+                                      std::span<const size_t> shadowLights,
+                                      std::vector<std::vector<ShadowCaster>> &casters) {
+    PROFILE_ZONE("FrustumCuller::cullShadowCasters");
+    casters_.clear();
+    casterBounds_.clear();
+    for (Model *model: models) {
+        if (model->calculateShadow) {
+            casters_.push_back(model);
+            casterBounds_.push_back(model->getWorldBounds());
+        }
+    }
+
+    shadowDraws = 0;
+    shadowFaces = 0;
+    casters.resize(shadowLights.size());
+    for (size_t light = 0; light < shadowLights.size(); light++) {
+        casters[light].clear();
+        const LightData &data = lights[shadowLights[light]];
+        glm::vec3 lightPosition = data.position;
+        float lightRadius = data.attenuation.r;
+
+        // a spot light has a single frustum in vp[0]
+        int faceCount = hasSpotShadow(data) ? 1 : 6;
+        unsigned int allFaces = (1u << faceCount) - 1;
+        Frustum faces[6];
+        for (int face = 0; face < faceCount; face++) {
+            faces[face] = Frustum::fromMatrix(data.vp[face]);
+        }
+
+        for (size_t i = 0; i < casters_.size(); i++) {
+            const Bounds &bounds = casterBounds_[i];
+            if (bounds.empty) {
+                casters[light].push_back({casters_[i], allFaces});
+                shadowFaces += faceCount;
+                continue;
+            }
+            if (glm::length(bounds.center - lightPosition) > bounds.radius + lightRadius) {
+                continue;
+            }
+            unsigned int faceMask = 0;
+            for (int face = 0; face < faceCount; face++) {
+                if (faces[face].intersectsBox(bounds)) {
+                    faceMask |= 1u << face;
+                    shadowFaces++;
+                }
+            }
+            if (faceMask != 0) {
+                casters[light].push_back({casters_[i], faceMask});
+            }
+        }
+        shadowDraws += casters[light].size();
+    }
+}
@@ -0,0 +1,112 @@
+/// @file FrustumCuller.h
+/// @brief This file contains the definition of the Frustum structure and the FrustumCuller class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_FRUSTUMCULLER_H
+#define PROJECT_FRUSTUMCULLER_H
+
+#include <span>
+#include <vector>
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+
+#include "../graphics/models/Bounds.h"
+
+class Model;
+struct LightData;
+
+/// @struct ShadowCaster
+/// @brief A model casting a shadow of a light together with the cube faces it is visible in.
+struct ShadowCaster {
+    /// @brief The model casting the shadow.
+    Model *model;
+
+    /// @brief The cube faces the model has to be drawn into, bit i stands for face i, only bit 0 for a spot light.
+    unsigned int faceMask;
+};
+
+/// @struct Frustum
+/// @brief The six planes of a view frustum, pointing inside.
+struct Frustum {
+    /// @brief The planes as (normal, distance), left, right, bottom, top, near, far.
+    glm::vec4 planes[6];
+
+    /// @brief Extracts the planes from a view-projection matrix.
+    /// @param viewProjection The view-projection matrix.
+    /// @return The frustum of the matrix.
+    static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+    /// @brief Tests whether a sphere intersects the frustum.
+    /// @param center The center of the sphere.
+    /// @param radius The radius of the sphere.
+    /// @return True if the sphere is at least partially inside, false otherwise.
+    bool intersectsSphere(const glm::vec3 &center, float radius) const;
+
+    /// @brief Tests whether an axis-aligned box intersects the frustum.
+    /// @param bounds The box.
+    /// @return True if the box is at least partially inside, false otherwise.
+    bool intersectsBox(const Bounds &bounds) const;
+};
+
+/// @class FrustumCuller
+/// @brief The FrustumCuller class selects the models whose world bounds intersect the view frustum.
+/// @details The world boxes are gathered into structure-of-arrays buffers and tested four at a time with SSE.
+/// Models without bounds are always visible. When frozen, the frustum of the frame the culler was frozen in is
+/// kept, so the culled objects can be inspected by moving the camera.
+class FrustumCuller {
+public:
+    /// @brief Flag indicating whether the frustum is frozen.
+    bool frozen = false;
+
+    /// @brief The number of models tested in the last frame.
+    size_t tested = 0;
+
+    /// @brief The number of models culled in the last frame.
+    size_t culled = 0;
+
+    /// @brief The number of caster and light pairs drawn into the shadow maps in the last frame.
+    size_t shadowDraws = 0;
+
+    /// @brief The number of cube faces the casters were drawn into in the last frame.
+    size_t shadowFaces = 0;
+
+    /// @brief Fills the visibility list with the models inside the frustum.
+    /// @param models The models to test.
+    /// @param viewProjection The view-projection matrix of the camera.
+    /// @param visible The list receiving the visible models.
+    void cull(std::span<Model *const> models, const glm::mat4 &viewProjection, std::vector<Model *> &visible);
+
+    /// @brief Selects the shadow casters of every light and the cube faces they are drawn into.
+    /// @details A caster is kept for a light if its bounding sphere intersects the sphere of the light, and only
+    /// the faces whose frusta intersect its box are set in the mask. Spot lights have a single face. Casters without
+    /// any face are dropped.
+    /// @param models The models to test, only the ones with calculateShadow set are considered.
+    /// @param lights The data of the lights, with the radius and the face matrices.
+    /// @param shadowLights The indices of the lights casting shadows.
+    /// @param casters The lists receiving the casters, one per shadow casting light.
+    void cullShadowCasters(std::span<Model *const> models, const LightData *lights, std::span<const size_t> shadowLights,
+                           std::vector<std::vector<ShadowCaster>> &casters);
+
+private:
+    /// @brief The view-projection matrix the frustum is built from, not updated while frozen.
+    glm::mat4 viewProjection_ = glm::mat4(1.0f);
+
+    /// @brief The models with bounds of the current frame.
+    std::vector<Model *> candidates_;
+
+    /// @brief The centers of the world boxes, one array per axis.
+    std::vector<float> centerX_, centerY_, centerZ_;
+
+    /// @brief The half sizes of the world boxes, one array per axis.
+    std::vector<float> extentX_, extentY_, extentZ_;
+
+    /// @brief The shadow casters of the current frame.
+    std::vector<Model *> casters_;
+
+    /// @brief The world bounds of the shadow casters.
+    std::vector<Bounds> casterBounds_;
+};
+
+#endif //PROJECT_FRUSTUMCULLER_H
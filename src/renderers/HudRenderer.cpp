@@ -1,14 +1,28 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <iostream>
+#include <cwchar>
+#include <cmath>
 
 #include "HudRenderer.h"
+#include "Renderer.h"
+#include "../benchmark/FrameStats.h"
 #include "../graphics/Shader.h"
+#include "../graphics/GLState.h"
 #include "../graphics/hud/Font.h"
 #include "../graphics/hud/Batch2D.h"
 #include "../window/Camera.h"
 #include "../window/Window.h"
 
+#define GRAPH_X 10
+#define GRAPH_Y 410 ///< The bottom of the frame time graph.
+#define GRAPH_BAR_WIDTH 2
+#define GRAPH_SCALE 3.0f ///< Pixels per millisecond.
+#define GRAPH_MAX_HEIGHT 150.0f
+#define FRAME_BUDGET_60 (1000.0 / 60.0)
+#define FRAME_BUDGET_30 (1000.0 / 30.0)
+
 
 HudRenderer::HudRenderer() {
     batch = new Batch2D(1024);
@@ -22,26 +36,79 @@ HudRenderer::~HudRenderer() {
     delete uicamera;
 }
 
-void HudRenderer::drawDebug(int fps) {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_DEPTH_TEST);
+void HudRenderer::drawDebug(const FrameStats &frameStats, const Renderer &renderer) {
+    GLState &state = GLState::instance();
+    state.enable(GL_BLEND);
+    state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.disable(GL_DEPTH_TEST);
 
 
     uiShader.use();
     uiShader.uniformInt("u_texture", 0);
-    glActiveTexture(GL_TEXTURE0);
+    state.activeTexture(GL_TEXTURE0);
     uiShader.uniformMatrix("u_projview", uicamera->getProjection() * uicamera->getView());
     batch->color = vec4(1.0f);
     batch->begin();
 
-    font.draw(batch, L"fps:" + std::to_wstring(fps), 10, 10, STYLE_OUTLINE);
+    font.draw(batch, L"fps:" + std::to_wstring(frameStats.fps()), 10, 10, STYLE_OUTLINE);
+
+    // gpu time of every pass, averaged over the rolling buffer of the timer
+    wchar_t time[32];
+    double total = 0.0;
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        double average = renderer.passTimer.average((RenderPass) pass);
+        total += average;
+        std::string name = RENDER_PASS_NAMES[pass];
+        std::swprintf(time, 32, L"%.2f ms", average);
+        font.draw(batch, std::wstring(name.begin(), name.end()) + L": " + time, 10, 30 + pass * 20, STYLE_OUTLINE);
+    }
+    std::swprintf(time, 32, L"%.2f ms", total);
+    font.draw(batch, std::wstring(L"gpu: ") + time, 10, 30 + PASS_COUNT * 20, STYLE_OUTLINE);
+
+    wchar_t percentiles[96];
+    std::swprintf(percentiles, 96, L"p50 %.1f p95 %.1f p99 %.1f max %.1f ms", frameStats.percentile(50.0),
+                  frameStats.percentile(95.0), frameStats.percentile(99.0), frameStats.max());
+    font.draw(batch, percentiles, 10, 50 + PASS_COUNT * 20, STYLE_OUTLINE);
+
+    std::wstring culling = L"culled: " + std::to_wstring(renderer.culler.culled) + L"/" +
+                           std::to_wstring(renderer.culler.tested);
+    if (renderer.culler.frozen) {
+        culling += L" (frozen)";
+    }
+    culling += L" draws: " + std::to_wstring(renderer.geometryDrawCalls);
+    culling += L" res: " + std::to_wstring((int) std::lround(renderer.resolution.scale * 100.0f)) + L"%";
+    font.draw(batch, culling, 10, 70 + PASS_COUNT * 20, STYLE_OUTLINE);
+    font.draw(batch, L"shadow draws: " + std::to_wstring(renderer.culler.shadowDraws) + L" faces: " +
+                     std::to_wstring(renderer.culler.shadowFaces) + L" updated: " +
+                     std::to_wstring(renderer.shadowUpdates) + L" calls: " +
+                     std::to_wstring(renderer.shadowDrawCalls) + L" atlas: " +
+                     std::to_wstring(renderer.shadowAtlas.usedTexels * 100 /
+                                     ((size_t) renderer.shadowAtlas.size * renderer.shadowAtlas.size)) + L"%",
+              10, 90 + PASS_COUNT * 20, STYLE_OUTLINE);
+    font.draw(batch, L"gl state calls: " + std::to_wstring(state.issued) + L" elided: " +
+                     std::to_wstring(state.elided), 10, 110 + PASS_COUNT * 20, STYLE_OUTLINE);
+
+    // frame time graph, one bar per frame of the sliding window, the oldest on the left
+    batch->texture(nullptr);
+    float budgetY = GRAPH_Y - (float) FRAME_BUDGET_60 * GRAPH_SCALE;
+    batch->rect(GRAPH_X, GRAPH_Y - GRAPH_MAX_HEIGHT, FRAME_STATS_WINDOW * GRAPH_BAR_WIDTH, GRAPH_MAX_HEIGHT,
+                0, 0, 1, 1, 0.0f, 0.0f, 0.0f, 0.4f);
+    for (size_t i = 0; i < frameStats.count(); i++) {
+        double frameTime = frameStats.frameTime(i);
+        float height = std::min((float) frameTime * GRAPH_SCALE, GRAPH_MAX_HEIGHT);
+        vec4 barColor = frameTime <= FRAME_BUDGET_60 ? vec4(0.2f, 0.9f, 0.2f, 1.0f)
+                      : frameTime <= FRAME_BUDGET_30 ? vec4(0.9f, 0.9f, 0.2f, 1.0f)
+                      : vec4(0.9f, 0.2f, 0.2f, 1.0f);
+        batch->rect(GRAPH_X + (float) (i * GRAPH_BAR_WIDTH), GRAPH_Y - height, GRAPH_BAR_WIDTH, height,
+                    0, 0, 1, 1, barColor.r, barColor.g, barColor.b, barColor.a);
+    }
+    batch->rect(GRAPH_X, budgetY, FRAME_STATS_WINDOW * GRAPH_BAR_WIDTH, 1, 0, 0, 1, 1, 1.0f, 1.0f, 1.0f, 0.6f);
 
     batch->render();
 
 
-    glEnable(GL_DEPTH_TEST);
-    glDisable(GL_BLEND);
+    state.enable(GL_DEPTH_TEST);
+    state.disable(GL_BLEND);
 }
 
 
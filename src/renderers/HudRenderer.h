@@ -10,6 +10,8 @@
 #include "../graphics/Shader.h"
 
 class Batch2D;
+class Renderer;
+class FrameStats;
 class Camera;
 class Mesh;
 
@@ -36,9 +38,10 @@ public:
     /// @brief Destructor for HudRenderer.
     ~HudRenderer();
 
-    /// @brief Draws debug information such as the current FPS.
-    /// @param fps The current frames per second to be displayed.
-    void drawDebug(int fps);
+    /// @brief Draws debug information such as the current FPS, frame time graph and GPU time of every render pass.
+    /// @param frameStats The frame time statistics to be displayed.
+    /// @param renderer The renderer holding the GPU timings of the render passes and the culling counters.
+    void drawDebug(const FrameStats &frameStats, const Renderer &renderer);
 };
 
 #endif /* PROJECT_HUDRENDER_H_ */
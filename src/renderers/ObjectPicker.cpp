@@ -0,0 +1,98 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include "GL/glew.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "ObjectPicker.h"
+#include "../graphics/GLState.h"
+
+ObjectPicker::ObjectPicker() {
+    for (auto &slot: slots_) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+ObjectPicker::~ObjectPicker() {
+    for (auto &slot: slots_) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+        }
+        glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+void ObjectPicker::request(PickAction action, float x, float y) {
+    pending_.push_back({action, x, y});
+}
+
+void ObjectPicker::capture(unsigned int framebuffer, unsigned int attachment, int width, int height) {
+    frame_++;
+    if (pending_.empty()) {
+        return;
+    }
+
+    GLState::instance().bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(attachment);
+    size_t taken = 0;
+    for (auto &slot: slots_) {
+        if (taken == pending_.size()) {
+            break;
+        }
+        if (slot.fence != nullptr) {
+            continue;
+        }
+        const PickRequest &pick = pending_[taken++];
+        int x = std::clamp((int) (pick.x * (float) width), 0, width - 1);
+        int y = std::clamp((int) (pick.y * (float) height), 0, height - 1);
+
+        // the copy into the buffer is queued like a draw, nothing waits for it here
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.action = pick.action;
+        slot.frame = frame_;
+        inFlight_.push_back(&slot - slots_);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    pending_.erase(pending_.begin(), pending_.begin() + (long) taken);
+}
+
+bool ObjectPicker::poll(PickResult &result) {
+    if (inFlight_.empty() || frame_ - slots_[inFlight_.front()].frame < OBJECT_PICKER_LATENCY) {
+        return false;
+    }
+    Slot &slot = slots_[inFlight_.front()];
+    inFlight_.pop_front();
+
+    // frames later the copy is done and the wait returns at once, it only blocks on a GPU that is far behind
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+        GLenum status = glClientWaitSync(slot.fence, flags, 1000000000);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            break;
+        }
+        if (status == GL_WAIT_FAILED) {
+            std::cerr << "Failed to wait for the object picker fence" << std::endl;
+            break;
+        }
+        flags = 0;
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    GLuint ID = 0;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeof(GLuint), &ID);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    result.action = slot.action;
+    result.ID = ID;
+    return true;
+}
@@ -0,0 +1,99 @@
+/// @file ObjectPicker.h
+/// @brief This file contains the definition of the ObjectPicker class and the pick requests and results.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_OBJECTPICKER_H
+#define PROJECT_OBJECTPICKER_H
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#define OBJECT_PICKER_SLOTS 4 ///< The number of read backs in flight.
+#define OBJECT_PICKER_LATENCY 2 ///< The number of frames a read back is resolved after, the GPU is done by then.
+
+typedef struct __GLsync *GLsync;
+
+/// @enum PickAction
+/// @brief What the scene does with the object under the cursor.
+enum PickAction {
+    PICK_SELECT = 0,
+    PICK_INTERACT
+};
+
+/// @struct PickRequest
+/// @brief A pick waiting for the next geometry pass.
+struct PickRequest {
+    PickAction action; ///< What to do with the picked object.
+    float x; ///< The horizontal position in [0, 1] from the left of the rendered image.
+    float y; ///< The vertical position in [0, 1] from the bottom of the rendered image.
+};
+
+/// @struct PickResult
+/// @brief A resolved pick.
+struct PickResult {
+    PickAction action; ///< What to do with the picked object.
+    size_t ID; ///< The ID of the object, 0 if there is none at the position.
+};
+
+/// @class ObjectPicker
+/// @brief The ObjectPicker class reads the object IDs of the G-buffer back without stalling the pipeline.
+/// @details After the geometry pass every pending request copies one texel of the R32UI object ID texture into a
+/// pixel pack buffer and places a fence behind it. The result is resolved OBJECT_PICKER_LATENCY frames later, when the
+/// copy has long finished, so the CPU never waits for the GPU and the results arrive in the same frame on every run.
+class ObjectPicker {
+public:
+    /// @brief Creates the pixel pack buffers.
+    ObjectPicker();
+
+    /// @brief Deletes the buffers and the fences in flight.
+    ~ObjectPicker();
+
+    ObjectPicker(const ObjectPicker &) = delete;
+
+    ObjectPicker &operator=(const ObjectPicker &) = delete;
+
+    /// @brief Queues a pick for the next geometry pass.
+    /// @param action What to do with the picked object.
+    /// @param x The horizontal position in [0, 1] from the left of the rendered image.
+    /// @param y The vertical position in [0, 1] from the bottom of the rendered image.
+    void request(PickAction action, float x = 0.5f, float y = 0.5f);
+
+    /// @brief Starts the read backs of the pending requests, called once per frame after the geometry pass.
+    /// @details Requests that find no free buffer wait for the next frame.
+    /// @param framebuffer The G-buffer.
+    /// @param attachment The color attachment holding the object IDs.
+    /// @param width The width of the rendered part of the attachment in pixels.
+    /// @param height The height of the rendered part of the attachment in pixels.
+    void capture(unsigned int framebuffer, unsigned int attachment, int width, int height);
+
+    /// @brief Takes the oldest resolved pick.
+    /// @param result Receives the pick.
+    /// @return True if a pick was resolved, false if none is due yet.
+    bool poll(PickResult &result);
+
+private:
+    /// @struct Slot
+    /// @brief A read back in flight.
+    struct Slot {
+        unsigned int buffer = 0; ///< The pixel pack buffer the ID is copied into.
+        GLsync fence = nullptr; ///< The fence behind the copy, nullptr if the slot is free.
+        PickAction action = PICK_SELECT; ///< What to do with the picked object.
+        size_t frame = 0; ///< The frame the copy was made in.
+    };
+
+    /// @brief The buffers, in use while their fence is set.
+    Slot slots_[OBJECT_PICKER_SLOTS];
+
+    /// @brief The indices of the slots in flight, oldest first.
+    std::deque<size_t> inFlight_;
+
+    /// @brief The requests waiting for the next geometry pass.
+    std::vector<PickRequest> pending_;
+
+    /// @brief The number of frames captured so far.
+    size_t frame_ = 0;
+};
+
+#endif //PROJECT_OBJECTPICKER_H
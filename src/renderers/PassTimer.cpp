@@ -0,0 +1,130 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+#include "GL/glew.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "PassTimer.h"
+
+const char *RENDER_PASS_NAMES[PASS_COUNT] = {
+        "shadows",
+        "geometry",
+        "lighting",
+        "skybox",
+        "crosshair",
+        "hud"
+};
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PassTimer::PassTimer() {
+    glGenQueries(PASS_TIMER_BUFFERS * PASS_COUNT, &queries_[0][0]);
+}
+
+PassTimer::~PassTimer() {
+    glDeleteQueries(PASS_TIMER_BUFFERS * PASS_COUNT, &queries_[0][0]);
+}
+
+void PassTimer::nextFrame() {
+    frame_ = (frame_ + 1) % PASS_TIMER_BUFFERS;
+    // this set was issued PASS_TIMER_BUFFERS frames ago and is about to be reused
+    resolve(frame_);
+}
+
+void PassTimer::begin(RenderPass pass) {
+    if (sync) {
+        glFinish();
+        startTimes_[pass] = now();
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries_[frame_][pass]);
+    issued_[frame_][pass] = true;
+}
+
+void PassTimer::end(RenderPass pass) {
+    glEndQuery(GL_TIME_ELAPSED);
+    if (sync) {
+        glFinish();
+        passTimes[pass] = (now() - startTimes_[pass]) * 1000.0;
+    }
+}
+
+void PassTimer::resolve(size_t set) {
+    bool any = false;
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        if (!issued_[set][pass]) {
+            continue;
+        }
+        any = true;
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries_[set][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            // never wait for the GPU, the frame is just not reported
+            droppedFrames++;
+            for (auto &issued: issued_[set]) {
+                issued = false;
+            }
+            return;
+        }
+    }
+    if (!any) {
+        return;
+    }
+
+    double total = 0.0;
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        double time = 0.0;
+        if (issued_[set][pass]) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(queries_[set][pass], GL_QUERY_RESULT, &elapsed);
+            time = (double) elapsed / 1.0e6;
+            issued_[set][pass] = false;
+        }
+        gpuTimes[pass] = time;
+        gpuTotals[pass] += time;
+        history_[historyIndex_][pass] = (float) time;
+        total += time;
+    }
+    historyIndex_ = (historyIndex_ + 1) % PASS_TIMER_HISTORY;
+    if (historyCount_ < PASS_TIMER_HISTORY) {
+        historyCount_++;
+    }
+    resolvedFrames++;
+
+    if (csv_.is_open()) {
+        csv_ << resolvedFrames;
+        for (double time: gpuTimes) {
+            csv_ << "," << time;
+        }
+        csv_ << "," << total << "\n";
+    }
+}
+
+double PassTimer::average(RenderPass pass) const {
+    if (historyCount_ == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < historyCount_; i++) {
+        sum += history_[i][pass];
+    }
+    return sum / (double) historyCount_;
+}
+
+bool PassTimer::openCsv(const std::string &fileName) {
+    csv_.open(fileName, std::ios::out | std::ios::trunc);
+    if (!csv_.is_open()) {
+        std::cerr << "Failed to open " << fileName << " for GPU timings" << std::endl;
+        return false;
+    }
+    csv_ << "frame";
+    for (auto &name: RENDER_PASS_NAMES) {
+        csv_ << "," << name;
+    }
+    csv_ << ",total\n";
+    std::cout << "Writing GPU pass timings to " << fileName << std::endl;
+    return true;
+}
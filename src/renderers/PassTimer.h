@@ -0,0 +1,115 @@
+/// @file PassTimer.h
+/// @brief This file contains the definition of the PassTimer class and the render pass identifiers.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_PASSTIMER_H
+#define PROJECT_PASSTIMER_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#define PASS_TIMER_BUFFERS 2 ///< Number of query sets in flight, results are read back this many frames later.
+#define PASS_TIMER_HISTORY 120 ///< Number of frames kept in the rolling buffer of GPU timings.
+
+/// @enum RenderPass
+/// @brief Identifies the passes executed by the scene every frame.
+enum RenderPass {
+    PASS_SHADOWS = 0,
+    PASS_GEOMETRY,
+    PASS_LIGHTING,
+    PASS_SKYBOX,
+    PASS_CROSSHAIR,
+    PASS_HUD,
+    PASS_COUNT
+};
+
+/// @brief Human readable names of the render passes, indexed by RenderPass.
+extern const char *RENDER_PASS_NAMES[PASS_COUNT];
+
+/// @class PassTimer
+/// @brief The PassTimer class measures how long every render pass takes.
+/// @details Every pass is wrapped in a GL_TIME_ELAPSED query. The query sets are double-buffered and read back
+/// only when their results are available, so the timer never stalls the pipeline; frames whose results are
+/// late are dropped. Resolved timings go to a rolling buffer and optionally to a CSV file.
+/// When sync is set, the timer additionally waits for the GPU with glFinish() around every pass and measures
+/// the wall time, which is meant for benchmark runs only.
+class PassTimer {
+public:
+    /// @brief Flag indicating whether the passes are also timed on the CPU with glFinish() synchronization.
+    bool sync = false;
+
+    /// @brief The synchronized wall time of every pass in the last frame, in milliseconds.
+    double passTimes[PASS_COUNT] = {};
+
+    /// @brief The GPU time of every pass in the last resolved frame, in milliseconds.
+    double gpuTimes[PASS_COUNT] = {};
+
+    /// @brief The sum of all resolved GPU times of every pass, in milliseconds.
+    double gpuTotals[PASS_COUNT] = {};
+
+    /// @brief The number of frames whose GPU timings were resolved.
+    size_t resolvedFrames = 0;
+
+    /// @brief The number of frames whose GPU timings were not available in time and were dropped.
+    size_t droppedFrames = 0;
+
+    /// @brief Constructs a PassTimer object and creates the query objects.
+    PassTimer();
+
+    /// @brief Destructor for PassTimer.
+    ~PassTimer();
+
+    /// @brief Starts a new frame, reads back the oldest query set if its results are available.
+    void nextFrame();
+
+    /// @brief Starts timing of the specified pass.
+    /// @param pass The pass to time.
+    void begin(RenderPass pass);
+
+    /// @brief Stops timing of the specified pass.
+    /// @param pass The pass being timed.
+    void end(RenderPass pass);
+
+    /// @brief Gets the average GPU time of a pass over the rolling buffer.
+    /// @param pass The pass to query.
+    /// @return The average time in milliseconds.
+    double average(RenderPass pass) const;
+
+    /// @brief Starts writing every resolved frame to a CSV file.
+    /// @param fileName The name of the CSV file.
+    /// @return True if the file was opened, false otherwise.
+    bool openCsv(const std::string &fileName);
+
+private:
+    /// @brief The query objects, one set per buffered frame.
+    unsigned int queries_[PASS_TIMER_BUFFERS][PASS_COUNT] = {};
+
+    /// @brief Flags indicating which queries were issued in the buffered frames.
+    bool issued_[PASS_TIMER_BUFFERS][PASS_COUNT] = {};
+
+    /// @brief The query set used by the current frame.
+    size_t frame_ = 0;
+
+    /// @brief The rolling buffer of resolved GPU times.
+    float history_[PASS_TIMER_HISTORY][PASS_COUNT] = {};
+
+    /// @brief The position in the rolling buffer the next frame is written to.
+    size_t historyIndex_ = 0;
+
+    /// @brief The number of valid frames in the rolling buffer.
+    size_t historyCount_ = 0;
+
+    /// @brief The start time of every pass, in seconds.
+    double startTimes_[PASS_COUNT] = {};
+
+    /// @brief The CSV file the resolved timings are written to.
+    std::ofstream csv_;
+
+    /// @brief Reads back a query set if all its results are available.
+    /// @param set The index of the query set.
+    void resolve(size_t set);
+};
+
+#endif //PROJECT_PASSTIMER_H
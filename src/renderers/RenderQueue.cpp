@@ -0,0 +1,103 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include "RenderQueue.h"
+#include "glm/matrix.hpp"
+#include "../graphics/models/Mesh.h"
+#include "../benchmark/Profiler.h"
+
+InstanceData InstanceData::fromModel(const glm::mat4 &model, size_t id) {
+    InstanceData data{};
+    data.model = model;
+    data.normalMatrix = glm::mat3x4(glm::transpose(glm::inverse(glm::mat3(model))));
+    data.id = (uint32_t) id;
+    return data;
+}
+
+uint64_t RenderQueue::makeKey(QueuePass pass, unsigned int shader, unsigned int material, float depth) {
+    // the bits of a non-negative float compare in the same order as the float itself
+    uint32_t depthBits;
+    depth = std::max(depth, 0.0f);
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+    return ((uint64_t) pass << RENDER_KEY_PASS_SHIFT) |
+           ((uint64_t) (shader & RENDER_KEY_SHADER_MASK) << RENDER_KEY_SHADER_SHIFT) |
+           ((uint64_t) (material & RENDER_KEY_MATERIAL_MASK) << RENDER_KEY_MATERIAL_SHIFT) |
+           depthBits;
+}
+
+void RenderQueue::clear() {
+    items_.clear();
+}
+
+void RenderQueue::push(uint64_t key, Model *model, Mesh *mesh, const glm::mat4 &modelMatrix, uint32_t instanceOffset,
+                       uint32_t instanceCount) {
+    items_.push_back({key, model, mesh, modelMatrix, instanceOffset, instanceCount});
+}
+
+void RenderQueue::sort() {
+    PROFILE_ZONE("RenderQueue::sort");
+    size_t count = items_.size();
+    keys_.resize(count);
+    scratch_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        keys_[i] = {items_[i].key, (uint32_t) i};
+    }
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (auto &key: keys_) {
+            histogram[(key.first >> shift) & 0xFF]++;
+        }
+        // all keys share this byte, the pass would not move anything
+        if (count == 0 || histogram[(keys_[0].first >> shift) & 0xFF] == count) {
+            continue;
+        }
+        size_t offset = 0;
+        for (auto &bucket: histogram) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (auto &key: keys_) {
+            scratch_[histogram[(key.first >> shift) & 0xFF]++] = key;
+        }
+        keys_.swap(scratch_);
+    }
+
+    sorted_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        sorted_[i] = items_[keys_[i].second];
+    }
+    items_.swap(sorted_);
+}
+
+void RenderQueue::buildCommands(bool mergeModels) {
+    batches_.clear();
+    commands_.clear();
+    for (size_t i = 0; i < items_.size(); i++) {
+        const RenderItem &item = items_[i];
+        bool indirect = item.mesh != nullptr && item.instanceCount > 0;
+        bool merged = false;
+        if (indirect && !batches_.empty() && batches_.back().indirect) {
+            // pass, shader and material are the bits above the depth
+            const RenderItem &first = items_[batches_.back().firstItem];
+            merged = (first.key >> RENDER_KEY_MATERIAL_SHIFT) == (item.key >> RENDER_KEY_MATERIAL_SHIFT) &&
+                     (mergeModels || first.model == item.model);
+        }
+        if (merged) {
+            batches_.back().itemCount++;
+        } else {
+            batches_.push_back({i, 1, commands_.size(), indirect});
+        }
+        if (indirect) {
+            const MeshRange &range = item.mesh->range;
+            commands_.push_back({range.indexCount, item.instanceCount, range.firstIndex, (int32_t) range.firstVertex,
+                                 item.instanceOffset});
+        }
+    }
+}
@@ -0,0 +1,182 @@
+/// @file RenderQueue.h
+/// @brief This file contains the definition of the RenderQueue class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_RENDERQUEUE_H
+#define PROJECT_RENDERQUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/mat3x4.hpp"
+#include "glm/mat4x4.hpp"
+
+class Model;
+class Mesh;
+
+// key layout, from the most significant bits: pass | shader | material | depth
+#define RENDER_KEY_PASS_SHIFT 62
+#define RENDER_KEY_SHADER_SHIFT 58
+#define RENDER_KEY_MATERIAL_SHIFT 32
+#define RENDER_KEY_SHADER_MASK 0xFu
+#define RENDER_KEY_MATERIAL_MASK 0x3FFFFFFu
+
+/// @enum QueuePass
+/// @brief The passes of the geometry stage in submission order.
+enum QueuePass {
+    QUEUE_PASS_OPAQUE = 0,
+    QUEUE_PASS_OUTLINE
+};
+
+/// @struct InstanceData
+/// @brief The data of one instance of an instanced draw, laid out as in the instance buffer (std430).
+struct InstanceData {
+    /// @brief The model matrix of the instance.
+    glm::mat4 model;
+
+    /// @brief The inverse transpose of the model matrix in the upper left 3x3, for the normals.
+    glm::mat3x4 normalMatrix;
+
+    /// @brief The ID of the model, written to the object ID buffer for picking and to the stencil for the outlines.
+    uint32_t id;
+
+    /// @brief Padding to the 16 byte alignment of the struct in the buffer.
+    uint32_t padding[3];
+
+    /// @brief Creates the data of an instance.
+    /// @param model The model matrix.
+    /// @param id The ID of the model.
+    /// @return The instance data with its normal matrix.
+    static InstanceData fromModel(const glm::mat4 &model, size_t id);
+};
+
+static_assert(sizeof(InstanceData) == 128, "InstanceData must match the std430 layout of res/instanceData.glsl");
+
+/// @struct DrawCommand
+/// @brief The arguments of one draw of glMultiDrawElementsIndirect, laid out as DrawElementsIndirectCommand.
+struct DrawCommand {
+    uint32_t count; ///< The number of indices.
+    uint32_t instanceCount; ///< The number of instances.
+    uint32_t firstIndex; ///< The first index in the index buffer of the mesh pool.
+    int32_t baseVertex; ///< The value added to every index.
+    uint32_t baseInstance; ///< The first instance, read by the shaders as gl_BaseInstance.
+};
+
+/// @struct DrawBatch
+/// @brief Consecutive draws of the sorted queue sharing the pass, shader and material.
+struct DrawBatch {
+    /// @brief The position of the first draw in the sorted queue, its state is used for the whole batch.
+    size_t firstItem;
+
+    /// @brief The number of draws.
+    size_t itemCount;
+
+    /// @brief The position of the first command in the command buffer.
+    size_t firstCommand;
+
+    /// @brief True if the draws are submitted by one glMultiDrawElementsIndirect, false for a single direct draw.
+    bool indirect;
+};
+
+/// @struct RenderItem
+/// @brief A single draw in the render queue.
+struct RenderItem {
+    /// @brief The sort key of the draw.
+    uint64_t key;
+
+    /// @brief The model being drawn.
+    Model *model;
+
+    /// @brief The mesh being drawn, nullptr to draw the whole model with Model::draw().
+    Mesh *mesh;
+
+    /// @brief The model matrix of the draw, unused by instanced draws.
+    glm::mat4 modelMatrix;
+
+    /// @brief The position of the first instance in the instance buffer.
+    uint32_t instanceOffset;
+
+    /// @brief The number of instances, 0 for a draw with the model matrix uniform.
+    uint32_t instanceCount;
+};
+
+/// @class RenderQueue
+/// @brief The RenderQueue class collects the draws of a frame and sorts them by their keys.
+/// @details The key packs the pass, shader, material and front-to-back depth of a draw, so after sorting the draws
+/// sharing a shader and a material are adjacent and the renderer only switches state between the groups.
+/// The keys are sorted with an LSD radix sort, which skips the bytes all keys have in common.
+class RenderQueue {
+public:
+    /// @brief Packs a sort key.
+    /// @param pass The pass of the draw.
+    /// @param shader The shader of the draw.
+    /// @param material The material identifier of the draw.
+    /// @param depth The squared distance from the camera, smaller values are drawn first.
+    /// @return The sort key.
+    static uint64_t makeKey(QueuePass pass, unsigned int shader, unsigned int material, float depth);
+
+    /// @brief Gets the pass stored in a key.
+    static QueuePass keyPass(uint64_t key) { return (QueuePass) (key >> RENDER_KEY_PASS_SHIFT); }
+
+    /// @brief Gets the shader stored in a key.
+    static unsigned int keyShader(uint64_t key) {
+        return (unsigned int) (key >> RENDER_KEY_SHADER_SHIFT) & RENDER_KEY_SHADER_MASK;
+    }
+
+    /// @brief Removes all draws from the queue, keeping the allocated memory.
+    void clear();
+
+    /// @brief Adds a draw to the queue.
+    /// @param key The sort key of the draw.
+    /// @param model The model being drawn.
+    /// @param mesh The mesh being drawn, nullptr to draw the whole model.
+    /// @param modelMatrix The model matrix of the draw.
+    /// @param instanceOffset The position of the first instance in the instance buffer.
+    /// @param instanceCount The number of instances, 0 for a draw with the model matrix uniform.
+    void push(uint64_t key, Model *model, Mesh *mesh, const glm::mat4 &modelMatrix, uint32_t instanceOffset = 0,
+              uint32_t instanceCount = 0);
+
+    /// @brief Sorts the draws by their keys.
+    void sort();
+
+    /// @brief Gets the draws of the queue, sorted after sort() was called.
+    /// @return The draws.
+    const std::vector<RenderItem> &items() const { return items_; }
+
+    /// @brief Groups the sorted draws into batches and writes the indirect commands of the instanced ones.
+    /// @details Adjacent instanced draws with the same pass, shader and material form one batch. Every other draw
+    /// is a batch of its own.
+    /// @param mergeModels Flag indicating whether draws of different models may share a batch, false if the
+    /// stencil ID of a batch comes from its first model.
+    void buildCommands(bool mergeModels);
+
+    /// @brief Gets the batches built by buildCommands().
+    /// @return The batches in submission order.
+    const std::vector<DrawBatch> &batches() const { return batches_; }
+
+    /// @brief Gets the indirect commands built by buildCommands().
+    /// @return The commands.
+    const std::vector<DrawCommand> &commands() const { return commands_; }
+
+private:
+    /// @brief The draws of the queue.
+    std::vector<RenderItem> items_;
+
+    /// @brief The draws in sorted order, swapped with items_ after sorting.
+    std::vector<RenderItem> sorted_;
+
+    /// @brief The keys with the indices of their draws.
+    std::vector<std::pair<uint64_t, uint32_t>> keys_;
+
+    /// @brief The scratch buffer of the radix sort.
+    std::vector<std::pair<uint64_t, uint32_t>> scratch_;
+
+    /// @brief The batches of the sorted draws.
+    std::vector<DrawBatch> batches_;
+
+    /// @brief The indirect commands of the batches.
+    std::vector<DrawCommand> commands_;
+};
+
+#endif //PROJECT_RENDERQUEUE_H
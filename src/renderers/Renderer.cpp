@@ -3,39 +3,275 @@
 //
 #include "GL/glew.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
 #include "Renderer.h"
 #include "../window/Window.h"
-#include "../graphics/models/Terrain.h"
 #include "glm/ext/matrix_transform.hpp"
-#include "../animation/AnimationPoint.h"
+#include "glm/matrix.hpp"
+#include "../benchmark/Profiler.h"
+#include "../graphics/GLState.h"
+
+
+Renderer::Renderer() {
+    glGenBuffers(1, &clusterGridSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterGridSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t) * lightClusters.grid.size(), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, clusterGridSSBO);
+
+    glGenBuffers(1, &clusterIndicesSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterIndicesSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, clusterIndicesSSBO);
+
+    glGenBuffers(1, &shadowPairsSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, shadowPairsSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::uvec2), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, shadowPairsSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glGenBuffers(1, &drawCommandsBuffer);
+    glGenBuffers(1, &shadowCommandsBuffer);
+
+    instancing = GLEW_ARB_shader_stencil_export;
+    if (!instancing) {
+        std::cout << "GL_ARB_shader_stencil_export is not supported, copies are drawn one by one" << std::endl;
+    }
+}
 
+void Renderer::beginFrame(std::span<Model *const> models, CameraPtr &camera, Lighting &lightingSystem) {
+    GLState::instance().nextFrame();
+
+    // every model is at most one instance of the shadow pass and one of the geometry pass
+    frameRing.beginFrame(sizeof(FrameData) + 2 * sizeof(InstanceData) * models.size(), 3);
+
+    FrameData frame{};
+    frame.view = camera->getView();
+    frame.projection = camera->getProjection();
+    frame.viewProjection = frame.projection * frame.view;
+    frame.inverseViewProjection = glm::inverse(frame.viewProjection);
+    frame.viewPos = glm::vec4(camera->position, 1.0f);
+    frame.sunDirection = glm::vec4(lightingSystem.sun.direction, 0.0f);
+    frame.sunColor = glm::vec4(lightingSystem.sun.color, 1.0f);
+    frame.fogColor = glm::vec4(lightingSystem.fog.color, 1.0f);
+    frame.fogDensity = lightingSystem.fog.density;
+    frame.sunEnabled = lightingSystem.sun.enabled;
+    frame.fogEnabled = lightingSystem.fog.enabled;
+    frameRing.upload(GL_UNIFORM_BUFFER, 0, &frame, sizeof(frame));
+}
 
-Renderer::Renderer() {}
+void Renderer::endFrame() {
+    frameRing.endFrame();
+}
 
-void Renderer::renderShadows(std::unordered_map<size_t, ModelPtr> &models, CameraPtr &camera, size_t lightsCount) {
-    glViewport(0, 0, (int) textureCubeArray.SHADOW_WIDTH, (int) textureCubeArray.SHADOW_HEIGHT);
-    glBindFramebuffer(GL_FRAMEBUFFER, textureCubeArray.depthMapFBO);
+void Renderer::assignShadowTiles(CameraPtr &camera, Lighting &lightingSystem) {
+    std::vector<size_t> &shadowLights = lightingSystem.shadowLights;
+    unsigned int maxTile = std::min((unsigned int) SHADOW_TILE_MAX, shadowAtlas.size / 4);
+    float halfHeight = camera->getProjection()[1][1] * (float) Window::HEIGHT * 0.5f;
+
+    bool changed = tiledLights_ != shadowLights;
+    tileSizes_.resize(shadowLights.size(), 0);
+    tileFaces_.resize(shadowLights.size(), 0);
+    for (size_t i = 0; i < shadowLights.size(); i++) {
+        const LightData &data = lightingSystem.lightsData[shadowLights[i]];
+        unsigned int faces = hasSpotShadow(data) ? 1 : 6;
+        changed |= faces != tileFaces_[i];
+        tileFaces_[i] = faces;
+        // the radius of the light sphere on screen in pixels, the whole atlas if the camera is inside it
+        float distance = glm::length(data.position - camera->position);
+        float radius = data.attenuation.r;
+        float coverage = (float) shadowAtlas.size;
+        if (distance > radius) {
+            coverage = radius / std::sqrt(distance * distance - radius * radius) * halfHeight;
+        }
 
-    textureCubeArray.bind();
-    shadowShader.use();
-    glClear(GL_DEPTH_BUFFER_BIT);
-    for (int i = 0; i < (int)lightsCount; i++) {
-        shadowShader.uniformInt("light_i", i);
-        for (auto &pair: models) {
-            auto model = pair.second;
-            if (!model->calculateShadow) {
-                continue;
+        // a light close to a size threshold keeps its tiles until the coverage moves 20% past it
+        unsigned int previous = tileSizes_[i];
+        if (previous != 0 && coverage > 0.4f * (float) previous && coverage <= 1.2f * (float) previous) {
+            continue;
+        }
+        unsigned int size = SHADOW_TILE_MIN;
+        while (size < maxTile && (float) size < coverage) {
+            size *= 2;
+        }
+        changed |= size != previous;
+        tileSizes_[i] = size;
+    }
+    if (!changed) {
+        return;
+    }
+
+    // reallocate the whole atlas from the largest tiles down, a light that does not fit gets smaller tiles
+    tiledLights_ = shadowLights;
+    tileOrder_.resize(shadowLights.size());
+    for (size_t i = 0; i < tileOrder_.size(); i++) {
+        tileOrder_[i] = i;
+    }
+    std::stable_sort(tileOrder_.begin(), tileOrder_.end(), [this](size_t a, size_t b) {
+        return tileSizes_[a] > tileSizes_[b];
+    });
+    shadowAtlas.reset();
+    lightTiles_.assign(shadowLights.size(), {});
+    for (size_t i: tileOrder_) {
+        for (unsigned int size = tileSizes_[i]; size >= SHADOW_TILE_MIN; size /= 2) {
+            if (shadowAtlas.allocate(size, tileFaces_[i], lightTiles_[i])) {
+                break;
             }
-            model->draw(shadowShader);
         }
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    for (auto &data: lightingSystem.lightsData) {
+        data.shadowTileSize = 0.0f;
+    }
+    auto atlasSize = (float) shadowAtlas.size;
+    for (size_t i = 0; i < shadowLights.size(); i++) {
+        LightData &data = lightingSystem.lightsData[shadowLights[i]];
+        const ShadowTiles &tiles = lightTiles_[i];
+        data.shadowTileSize = (float) tiles.size / atlasSize;
+        for (int face = 0; face < 6; face += 2) {
+            data.shadowTiles[face / 2] = glm::vec4(glm::vec2(tiles.offsets[face]) / atlasSize,
+                                                   glm::vec2(tiles.offsets[face + 1]) / atlasSize);
+        }
+    }
+    lightingSystem.upload();
 }
 
-void Renderer::renderGeometry(std::unordered_map<size_t, ModelPtr> &models, std::vector<CameraPtr> &cameras,
+void Renderer::renderShadows(std::span<Model *const> models, CameraPtr &camera, Lighting &lightingSystem) {
+    GLState &state = GLState::instance();
+    assignShadowTiles(camera, lightingSystem);
+
+    std::vector<size_t> &shadowLights = lightingSystem.shadowLights;
+    culler.cullShadowCasters(models, lightingSystem.lightsData.data(), shadowLights, shadowCasters);
+    shadowSlots_.resize(shadowLights.size());
+
+    shadowUpdates = 0;
+    shadowDrawCalls = 0;
+    batchIndex_.clear();
+    batchCount_ = 0;
+    shadowInstanceIndex_.clear();
+    shadowInstances_.clear();
+    for (int i = 0; i < (int) shadowLights.size(); i++) {
+        Light *light = lightingSystem.lights[shadowLights[i]].get();
+        ShadowSlot &slot = shadowSlots_[i];
+        const ShadowTiles &tiles = lightTiles_[i];
+        if (tiles.size == 0) {
+            continue;
+        }
+
+        // the tiles of the light are kept while neither the light, its tiles nor any of its casters changed
+        currentCasters_.clear();
+        for (auto &caster: shadowCasters[i]) {
+            currentCasters_.push_back({caster.model, caster.model->ID, caster.model->getModelMatrixQuat()});
+        }
+        if (!light->needUpdate && slot.light == light && slot.tiles == tiles && slot.casters == currentCasters_) {
+            continue;
+        }
+        slot.light = light;
+        slot.tiles = tiles;
+        slot.casters.swap(currentCasters_);
+        light->needUpdate = false;
+        shadowUpdates++;
+
+        shadowAtlas.clear(tiles);
+
+        // every face the caster touches becomes one instance of the draw of its meshes, shared by its copies
+        for (auto &caster: shadowCasters[i]) {
+            auto [instance, added] = shadowInstanceIndex_.try_emplace(caster.model, (uint32_t) shadowInstances_.size());
+            if (added) {
+                shadowInstances_.push_back(InstanceData::fromModel(caster.model->getModelMatrixQuat(), caster.model->ID));
+            }
+            const void *meshes = caster.model->meshes.empty() || caster.model->hasCustomDraw()
+                                 ? (const void *) caster.model : caster.model->meshes.front().get();
+            auto [entry, inserted] = batchIndex_.try_emplace(meshes, batchCount_);
+            if (inserted) {
+                if (batchCount_ == shadowBatches_.size()) {
+                    shadowBatches_.emplace_back();
+                }
+                shadowBatches_[batchCount_].model = caster.model;
+                shadowBatches_[batchCount_].pairs.clear();
+                batchCount_++;
+            }
+            ShadowBatch &batch = shadowBatches_[entry->second];
+            for (unsigned int face = 0; face < tiles.faces; face++) {
+                if (caster.faceMask & (1u << face)) {
+                    batch.pairs.emplace_back((unsigned int) shadowLights[i], face | instance->second << 3);
+                }
+            }
+        }
+    }
+    if (batchCount_ == 0) {
+        return;
+    }
+
+    shadowPairs_.clear();
+    for (size_t b = 0; b < batchCount_; b++) {
+        shadowBatches_[b].offset = shadowPairs_.size();
+        shadowPairs_.insert(shadowPairs_.end(), shadowBatches_[b].pairs.begin(), shadowBatches_[b].pairs.end());
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, shadowPairsSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::uvec2) * shadowPairs_.size(), shadowPairs_.data(),
+                 GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, shadowPairsSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    frameRing.upload(GL_SHADER_STORAGE_BUFFER, 4, shadowInstances_.data(), sizeof(InstanceData) * shadowInstances_.size());
+
+    // the vertex shader moves every instance into its tile and clips it to the tile edges
+    state.bindFramebuffer(GL_FRAMEBUFFER, shadowAtlas.depthMapFBO);
+    glViewport(0, 0, (int) shadowAtlas.size, (int) shadowAtlas.size);
+    for (int plane = 0; plane < 4; plane++) {
+        state.enable(GL_CLIP_DISTANCE0 + plane);
+    }
+    shadowShader.use();
+
+    // the casters with pooled meshes go into one indirect draw, every mesh of a batch is one command
+    shadowCommands_.clear();
+    for (size_t b = 0; b < batchCount_; b++) {
+        ShadowBatch &batch = shadowBatches_[b];
+        if (batch.model->hasCustomDraw()) {
+            continue;
+        }
+        for (auto &mesh: batch.model->meshes) {
+            const MeshRange &range = mesh->range;
+            shadowCommands_.push_back({range.indexCount, (uint32_t) batch.pairs.size(), range.firstIndex,
+                                       (int32_t) range.firstVertex, (uint32_t) batch.offset});
+        }
+    }
+    if (!shadowCommands_.empty()) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, shadowCommandsBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawCommand) * shadowCommands_.size(), shadowCommands_.data(),
+                     GL_DYNAMIC_DRAW);
+        shadowShader.uniformInt("pairOffset", 0);
+        state.bindVertexArray(MeshPool::instance().vao);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei) shadowCommands_.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        shadowDrawCalls++;
+    }
+
+    for (size_t b = 0; b < batchCount_; b++) {
+        ShadowBatch &batch = shadowBatches_[b];
+        if (batch.model->hasCustomDraw()) {
+            // a custom draw is not instanced, it is repeated for every pair
+            for (size_t pair = 0; pair < batch.pairs.size(); pair++) {
+                shadowShader.use();
+                shadowShader.uniformInt("pairOffset", (int) (batch.offset + pair));
+                batch.model->draw(shadowShader);
+                shadowDrawCalls++;
+            }
+            shadowShader.use();
+        }
+    }
+    for (int plane = 0; plane < 4; plane++) {
+        state.disable(GL_CLIP_DISTANCE0 + plane);
+    }
+    state.bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Renderer::renderGeometry(std::span<Model *const> models, std::vector<CameraPtr> &cameras,
                               Lighting &lightingSystem) {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState &state = GLState::instance();
+    state.bindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // geometry pass: render scene's geometry/color data into gbuffer
     // -----------------------------------------------------------------------------------------------------------------
@@ -44,9 +280,18 @@ void Renderer::renderGeometry(std::unordered_map<size_t, ModelPtr> &models, std:
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer.gbuffer);
+    // the textures keep the window size, the scaled passes only cover their lower left part
+    gbuffer.resize(Window::WIDTH, Window::HEIGHT);
+    renderWidth_ = resolution.scaled(Window::WIDTH);
+    renderHeight_ = resolution.scaled(Window::HEIGHT);
+
+    state.bindFramebuffer(GL_FRAMEBUFFER, gbuffer.gbuffer);
+    glViewport(0, 0, renderWidth_, renderHeight_);
     glClearStencil(0);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    // glClear leaves integer buffers undefined, 0 is the background for picking
+    const GLuint noObject[4] = {0, 0, 0, 0};
+    glClearBufferuiv(GL_COLOR, (GLint) gbuffer.objectIDBuffer, noObject);
 
     CameraPtr currCamera;
     for (auto &camera: cameras) {
@@ -56,121 +301,265 @@ void Renderer::renderGeometry(std::unordered_map<size_t, ModelPtr> &models, std:
     }
 
     shaderGeometryPass.use();
-    shaderGeometryPass.uniformMatrix("projection", currCamera->getProjection());
-    shaderGeometryPass.uniformMatrix("view", currCamera->getView());
-
     lightingSystem.draw(shaderGeometryPass);
 
 
+    state.enable(GL_STENCIL_TEST);
+    state.stencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    state.stencilMask(0xFF);
+    Uniform<int> objectID = shaderGeometryPass.uniform<int>("objectID");
     for (auto &camera: cameras) {
-        glEnable(GL_STENCIL_TEST);
-        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-        glStencilFunc(GL_ALWAYS, (int) camera->ID, -1);
+        shaderGeometryPass.set(objectID, (int) camera->ID);
+        state.stencilFunc(GL_ALWAYS, (int) camera->ID, -1);
         camera->draw(shaderGeometryPass);
-        glStencilMask(0xFF);
-        glStencilFunc(GL_ALWAYS, 0, -1);
-        glDisable(GL_STENCIL_TEST);
-    }
-
-    for (auto &pair: models) {
-        auto model = pair.second;
-        if (std::dynamic_pointer_cast<Terrain>(model)) {
-            shaderGeometryPassMountains.use();
-            shaderGeometryPassMountains.uniformMatrix("projection", currCamera->getProjection());
-            shaderGeometryPassMountains.uniformMatrix("view", currCamera->getView());
-            glEnable(GL_STENCIL_TEST);
-            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-            glStencilFunc(GL_ALWAYS, (int) model->ID, -1);
-            model->draw(shaderGeometryPassMountains);
-            glStencilFunc(GL_NOTEQUAL, (int) model->ID, 0xFF);
-            glStencilMask(0x00);
-
-
-        } else if (std::dynamic_pointer_cast<Model>(model)) {
-            if (std::dynamic_pointer_cast<AnimationPoint>(model)) {
-                if (std::dynamic_pointer_cast<AnimationPoint>(model)->hide) continue;
-            }
-            shaderGeometryPass.use();
-            glEnable(GL_STENCIL_TEST);
-            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-            glStencilFunc(GL_ALWAYS, (int) model->ID, -1);
+    }
+    state.stencilFunc(GL_ALWAYS, 0, -1);
+    state.disable(GL_STENCIL_TEST);
 
-            model->draw(shaderGeometryPass);
+    culler.cull(models, currCamera->getProjection() * currCamera->getView(), visibleModels);
+    buildRenderQueue(visibleModels, currCamera);
+    submitRenderQueue();
 
-            glStencilFunc(GL_NOTEQUAL, (int) model->ID, 0xFF);
-            glStencilMask(0x00);
+    picker.capture(gbuffer.gbuffer, gbuffer.attachments[gbuffer.objectIDBuffer], renderWidth_, renderHeight_);
 
-        }
-        outlineShader.use();
-        outlineShader.uniformMatrix("projection", currCamera->getProjection());
-        outlineShader.uniformMatrix("view", currCamera->getView());
+    state.bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
+void Renderer::buildRenderQueue(std::span<Model *const> models, CameraPtr &camera) {
+    PROFILE_ZONE("Renderer::buildRenderQueue");
+    renderQueue.clear();
+    groupIndex_.clear();
+    groupCount_ = 0;
+    for (Model *model: models) {
+        if (model->hidden()) {
+            continue;
+        }
+        glm::mat4 modelMatrix = model->getModelMatrixQuat();
+        glm::vec3 toCamera = model->position - camera->position;
+        float depth = glm::dot(toCamera, toCamera);
+        GeometryShader shader = model->geometryShader();
+
+        if (model->hasCustomDraw()) {
+            renderQueue.push(RenderQueue::makeKey(QUEUE_PASS_OPAQUE, shader, 0, depth), model, nullptr, modelMatrix);
+        } else if ((shader == GEOMETRY_SHADER_DEFAULT || shader == GEOMETRY_SHADER_MOUNTAINS) &&
+                   !model->meshes.empty()) {
+            // copies share their meshes, so the first mesh identifies the group
+            size_t index = groupCount_;
+            if (instancing) {
+                index = groupIndex_.try_emplace(model->meshes.front().get(), groupCount_).first->second;
+            }
+            if (index == groupCount_) {
+                if (groupCount_ == instanceGroups_.size()) {
+                    instanceGroups_.emplace_back();
+                }
+                instanceGroups_[groupCount_].model = model;
+                instanceGroups_[groupCount_].shader = shader == GEOMETRY_SHADER_MOUNTAINS ? GEOMETRY_SHADER_MOUNTAINS
+                                                                                         : GEOMETRY_SHADER_INSTANCED;
+                instanceGroups_[groupCount_].instances.clear();
+                instanceGroups_[groupCount_].depth = depth;
+                groupCount_++;
+            }
+            InstanceGroup &group = instanceGroups_[index];
+            group.instances.push_back(InstanceData::fromModel(modelMatrix, model->ID));
+            group.depth = std::min(group.depth, depth);
+        } else {
+            for (auto &mesh: model->meshes) {
+                renderQueue.push(RenderQueue::makeKey(QUEUE_PASS_OPAQUE, shader, mesh->materialID, depth),
+                                 model, mesh.get(), modelMatrix);
+            }
+        }
         if (model->selectionMode) {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+            renderQueue.push(RenderQueue::makeKey(QUEUE_PASS_OUTLINE, GEOMETRY_SHADER_OUTLINE, 0, depth),
+                             model, nullptr, modelMatrix);
+        }
+    }
+
+    instances_.clear();
+    for (size_t g = 0; g < groupCount_; g++) {
+        InstanceGroup &group = instanceGroups_[g];
+        auto offset = (uint32_t) instances_.size();
+        instances_.insert(instances_.end(), group.instances.begin(), group.instances.end());
+        for (auto &mesh: group.model->meshes) {
+            renderQueue.push(RenderQueue::makeKey(QUEUE_PASS_OPAQUE, group.shader, mesh->materialID, group.depth),
+                             group.model, mesh.get(), glm::mat4(1.0f), offset, (uint32_t) group.instances.size());
+        }
+    }
+    frameRing.upload(GL_SHADER_STORAGE_BUFFER, 4, instances_.data(), sizeof(InstanceData) * instances_.size());
+
+    renderQueue.sort();
+    renderQueue.buildCommands(instancing);
+    const std::vector<DrawCommand> &commands = renderQueue.commands();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandsBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawCommand) * std::max(commands.size(), (size_t) 1), nullptr,
+                 GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(DrawCommand) * commands.size(), commands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void Renderer::submitRenderQueue() {
+    GLState &state = GLState::instance();
+    Shader *shaders[] = {&shaderGeometryPass, &shaderGeometryPassMountains, &outlineShader, &shaderGeometryInstanced};
+
+    // every draw writes the ID of its model to the object ID buffer for picking and to the stencil for the outlines
+    state.enable(GL_STENCIL_TEST);
+    state.stencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    state.stencilMask(0xFF);
+
+    geometryDrawCalls = 0;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandsBuffer);
+    int currentPass = QUEUE_PASS_OPAQUE;
+    int currentShader = -1;
+    unsigned int currentMaterial = 0;
+    Model *currentModel = nullptr;
+    Uniform<glm::mat4> modelUniform;
+    Uniform<int> objectIDUniform;
+    for (auto &batch: renderQueue.batches()) {
+        const RenderItem &item = renderQueue.items()[batch.firstItem];
+        QueuePass pass = RenderQueue::keyPass(item.key);
+        if (pass != currentPass) {
+            // outlines are drawn around the objects, where the stencil holds another ID
+            state.stencilMask(0x00);
+            glColorMaski(gbuffer.objectIDBuffer, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            state.polygonMode(GL_LINE);
             glLineWidth(10.0f);
-            model->draw(outlineShader);
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            currentPass = pass;
+            currentModel = nullptr;
+        }
 
+        unsigned int shaderIndex = RenderQueue::keyShader(item.key);
+        Shader &shader = *shaders[shaderIndex];
+        if ((int) shaderIndex != currentShader) {
+            shader.use();
+            modelUniform = shader.uniform<glm::mat4>("model");
+            objectIDUniform = shader.uniform<int>("objectID");
+            currentShader = (int) shaderIndex;
+            currentMaterial = 0;
+            currentModel = nullptr;
         }
-        glStencilMask(0xFF);
-        glStencilFunc(GL_ALWAYS, 0, -1);
-        glDisable(GL_STENCIL_TEST);
 
-    }
+        if (item.model != currentModel) {
+            if (pass == QUEUE_PASS_OPAQUE) {
+                state.stencilFunc(GL_ALWAYS, (int) item.model->ID, -1);
+                // the instanced shaders take the IDs from the instance data
+                shader.set(objectIDUniform, (int) item.model->ID);
+            } else {
+                state.stencilFunc(GL_NOTEQUAL, (int) item.model->ID, 0xFF);
+            }
+            if (item.mesh != nullptr && item.instanceCount == 0) {
+                shader.set(modelUniform, item.modelMatrix);
+            }
+            currentModel = item.model;
+        }
 
+        geometryDrawCalls++;
+        if (item.mesh == nullptr) {
+            item.model->draw(shader);
+            // the model binds its own textures
+            currentMaterial = 0;
+            continue;
+        }
+        if (item.mesh->materialID != currentMaterial) {
+            item.mesh->bindMaterial();
+            currentMaterial = item.mesh->materialID;
+        }
+        if (batch.indirect) {
+            // the instances write their own IDs
+            state.bindVertexArray(MeshPool::instance().vao);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                        (void *) (sizeof(DrawCommand) * batch.firstCommand),
+                                        (GLsizei) batch.itemCount, 0);
+        } else {
+            item.mesh->drawElements();
+        }
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (currentPass == QUEUE_PASS_OUTLINE) {
+        state.polygonMode(GL_FILL);
+        glColorMaski(gbuffer.objectIDBuffer, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+    state.activeTexture(GL_TEXTURE0);
+    state.stencilMask(0xFF);
+    state.stencilFunc(GL_ALWAYS, 0, -1);
+    state.disable(GL_STENCIL_TEST);
 }
 
 void Renderer::renderLighting(CameraPtr &camera, Lighting &lightingSystem) {
+    GLState &state = GLState::instance();
     //  lighting pass: calculate lighting by iterating over a screen filled quad pixel-by-pixel using the gbuffer's content.
     // -----------------------------------------------------------------------------------------------------------------
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    glm::mat4 view = camera->getView();
+    lightClusters.build(view, camera->getProjection(), lightingSystem.lightsData.data(),
+                        lightingSystem.lightsData.size());
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterGridSSBO);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t) * lightClusters.grid.size(),
+                    lightClusters.grid.data());
+    // orphan the index buffer, its size changes every frame
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterIndicesSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t) * std::max(lightClusters.lightIndices.size(), (size_t) 1),
+                 nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t) * lightClusters.lightIndices.size(),
+                    lightClusters.lightIndices.data());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, clusterIndicesSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    state.bindFramebuffer(GL_FRAMEBUFFER, gbuffer.lightingFBO);
+    glViewport(0, 0, renderWidth_, renderHeight_);
     shaderLightingPassNew.use();
     shaderLightingPassNew.uniformInt("gPosition", 0);
     shaderLightingPassNew.uniformInt("gNormal", 1);
     shaderLightingPassNew.uniformInt("gDiffuseShininess", 2);
     shaderLightingPassNew.uniformInt("gAmbientSpecular", 3);
-    shaderLightingPassNew.uniformInt("depthMap", 4);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, gbuffer.gPosition);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, gbuffer.gNormal);
-    glActiveTexture(GL_TEXTURE2);
-    glBindTexture(GL_TEXTURE_2D, gbuffer.gDiffuseShininess);
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_2D, gbuffer.gAmbientSpecular);
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, textureCubeArray.textureCubeArray);
-
-    shaderLightingPassNew.uniformVec3("viewPos", camera->position);
-    shaderLightingPassNew.uniformInt("lightsCount", (int) lightingSystem.lights.size());
-
-    shaderLightingPassNew.uniformVec3("sun.direction", lightingSystem.sun.direction);
-    shaderLightingPassNew.uniformVec3("sun.color", lightingSystem.sun.color);
-    shaderLightingPassNew.uniformBool("sun.enabled", lightingSystem.sun.enabled);
-
-    shaderLightingPassNew.uniformVec3("fog.color", lightingSystem.fog.color);
-    shaderLightingPassNew.uniformFloat("fog.density", lightingSystem.fog.density);
-    shaderLightingPassNew.uniformBool("fog.enabled", lightingSystem.fog.enabled);
+    shaderLightingPassNew.uniformInt("shadowAtlas", 4);
+    shaderLightingPassNew.uniformInt("gDepth", 5);
+    state.activeTexture(GL_TEXTURE0);
+    state.bindTexture(GL_TEXTURE_2D, gbuffer.gPosition);
+    state.activeTexture(GL_TEXTURE5);
+    state.bindTexture(GL_TEXTURE_2D, gbuffer.gDepth);
+    state.activeTexture(GL_TEXTURE1);
+    state.bindTexture(GL_TEXTURE_2D, gbuffer.gNormal);
+    state.activeTexture(GL_TEXTURE2);
+    state.bindTexture(GL_TEXTURE_2D, gbuffer.gDiffuseShininess);
+    state.activeTexture(GL_TEXTURE3);
+    state.bindTexture(GL_TEXTURE_2D, gbuffer.gAmbientSpecular);
+    state.activeTexture(GL_TEXTURE4);
+    shadowAtlas.bind();
+
+    glm::vec2 uvScale = glm::vec2((float) renderWidth_ / (float) gbuffer.width,
+                                  (float) renderHeight_ / (float) gbuffer.height);
+    shaderLightingPassNew.uniformVec2("screenSize", glm::vec2(renderWidth_, renderHeight_));
+    shaderLightingPassNew.uniformVec2("uvScale", uvScale);
+    // slice = log(depth) * scale - bias, the same mapping as LightClusters::slice
+    float sliceScale = CLUSTERS_Z / std::log(lightClusters.zFar / lightClusters.zNear);
+    shaderLightingPassNew.uniformVec2("clusterSlice", glm::vec2(sliceScale, std::log(lightClusters.zNear) * sliceScale));
 
     // finally render quad
     renderQuad();
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // scale the lit image up to the window, bilinear filtering clamped to the rendered part
+    state.bindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, Window::WIDTH, Window::HEIGHT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    upscaleShader.use();
+    upscaleShader.uniformInt("image", 0);
+    upscaleShader.uniformVec2("uvScale", uvScale);
+    upscaleShader.uniformVec2("maxUV", uvScale - glm::vec2(0.5f / (float) gbuffer.width, 0.5f / (float) gbuffer.height));
+    state.activeTexture(GL_TEXTURE0);
+    state.bindTexture(GL_TEXTURE_2D, gbuffer.gLighting);
+    renderQuad();
+    state.bindTexture(GL_TEXTURE_2D, 0);
 
     // copy content of geometry's depth buffer to default framebuffer's depth buffer
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, gbuffer.gbuffer);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-    glBlitFramebuffer(0, 0, Window::WIDTH, Window::HEIGHT, 0, 0, Window::WIDTH, Window::HEIGHT, GL_DEPTH_BUFFER_BIT,
-                      GL_NEAREST);
-    glBlitFramebuffer(0, 0, Window::WIDTH, Window::HEIGHT, 0, 0, Window::WIDTH, Window::HEIGHT, GL_STENCIL_BUFFER_BIT,
-                      GL_NEAREST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    state.bindFramebuffer(GL_READ_FRAMEBUFFER, gbuffer.gbuffer);
+    state.bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, renderWidth_, renderHeight_, 0, 0, Window::WIDTH, Window::HEIGHT,
+                      GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+    state.bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Renderer::renderQuad() {
+    GLState &state = GLState::instance();
 
     if (quadVAO == 0) {
         float quadVertices[] = {
@@ -183,7 +572,7 @@ void Renderer::renderQuad() {
         // setup plane VAO
         glGenVertexArrays(1, &quadVAO);
         glGenBuffers(1, &quadVBO);
-        glBindVertexArray(quadVAO);
+        state.bindVertexArray(quadVAO);
         glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
@@ -191,31 +580,23 @@ void Renderer::renderQuad() {
         glEnableVertexAttribArray(1);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *) (3 * sizeof(float)));
     }
-    glBindVertexArray(quadVAO);
+    state.bindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
 
 }
 
-void Renderer::renderSkybox(SkyBox &skybox, CameraPtr &camera, Lighting &lightingSystem) {
-    glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
-    glDepthFunc(
+void Renderer::renderSkybox(SkyBox &skybox) {
+    GLState &state = GLState::instance();
+    state.depthMask(GL_FALSE);
+    state.enable(GL_BLEND);
+    state.depthFunc(
             GL_LEQUAL);
     skyboxShader.use();
-    glm::mat4 view = glm::mat4(
-            glm::mat3(camera->getView()));
-    skyboxShader.uniformMatrix("view", view);
-    skyboxShader.uniformMatrix("projection", camera->getProjection());
-
-    skyboxShader.uniformBool("sunEnabled", lightingSystem.sun.enabled);
-    skyboxShader.uniformBool("fogEnabled", lightingSystem.fog.enabled);
-    skyboxShader.uniformVec3("fogColor", lightingSystem.fog.color);
     skybox.draw(skyboxShader);
-    glDisable(GL_BLEND);
+    state.disable(GL_BLEND);
 
-    glDepthMask(GL_TRUE);
-    glDepthFunc(
+    state.depthMask(GL_TRUE);
+    state.depthFunc(
             GL_LESS);
 }
 
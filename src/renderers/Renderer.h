@@ -6,26 +6,89 @@
 #ifndef PROJECT_RENDERER_H
 #define PROJECT_RENDERER_H
 
+#include <span>
 #include <unordered_map>
 #include "../graphics/models/Model.h"
 #include "../window/Camera.h"
-#include "../graphics/TextureCubeArray.h"
+#include "../graphics/ShadowAtlas.h"
 #include "../graphics/lighting/Lighting.h"
 #include "../graphics/gBuffer.h"
 #include "../graphics/SkyBox.h"
 #include "../graphics/AxesCrosshair.h"
+#include "PassTimer.h"
+#include "DynamicResolution.h"
+#include "RenderQueue.h"
+#include "FrameRing.h"
+#include "ObjectPicker.h"
+#include "FrustumCuller.h"
+#include "../graphics/lighting/LightClusters.h"
+
+/// @struct ShadowSlot
+/// @brief The state the shadow map of a light was rendered with, used to skip lights that did not change.
+struct ShadowSlot {
+    /// @brief A caster drawn into the cube.
+    struct Caster {
+        Model *model; ///< The model.
+        size_t ID; ///< The ID of the model, guards against a new model reusing the address of a deleted one.
+        glm::mat4 modelMatrix; ///< The model matrix the caster was drawn with.
+
+        bool operator==(const Caster &other) const = default;
+    };
+
+    /// @brief The light the slot belongs to, nullptr if the slot was never rendered.
+    Light *light = nullptr;
+
+    /// @brief The atlas tiles the shadow map was rendered into.
+    ShadowTiles tiles;
+
+    /// @brief The casters drawn into the shadow map.
+    std::vector<Caster> casters;
+};
+
+/// @struct ShadowBatch
+/// @brief The (light, face) pairs the casters sharing a set of meshes are drawn into, one instance per pair.
+/// @details The pairs of a batch start at its offset, which is the base instance of its indirect commands.
+struct ShadowBatch {
+    /// @brief The first caster, its meshes are drawn for all of them.
+    Model *model = nullptr;
+
+    /// @brief The index of the light of every instance, and its face with the index of the caster's instance data.
+    std::vector<glm::uvec2> pairs;
+
+    /// @brief The position of the first pair in the shadow pair buffer.
+    size_t offset = 0;
+};
+
+/// @struct InstanceGroup
+/// @brief The visible copies of a model drawn by one instanced draw per mesh.
+struct InstanceGroup {
+    /// @brief The first copy, its meshes are drawn for all of them.
+    Model *model = nullptr;
+
+    /// @brief The shader the copies are drawn with, reading their instance data.
+    GeometryShader shader = GEOMETRY_SHADER_INSTANCED;
+
+    /// @brief The instance data of every copy.
+    std::vector<InstanceData> instances;
+
+    /// @brief The depth of the nearest copy.
+    float depth = 0.0f;
+};
 
 /// @class Renderer
 /// @brief The Renderer class is responsible for rendering the scene.
 /// @details This class handles shadow mapping, geometry rendering, lighting, skybox, and crosshair rendering.
 class Renderer {
 public:
-    /// @brief Shader for shadow mapping.
-    Shader shadowShader = Shader("res/shadowDepth.vert", "res/shadowDepth.frag", "res/shadowDepth.geom");
+    /// @brief Shader for shadow mapping, every instance is drawn into the atlas tile of one (light, face) pair.
+    Shader shadowShader = Shader("res/shadowDepth.vert", "res/shadowDepth.frag");
 
     /// @brief Shader for the geometry pass.
     Shader shaderGeometryPass = Shader("res/shaderGeometry.vert", "res/shaderGeometry.frag");
 
+    /// @brief Shader for the geometry pass drawing all copies of a mesh with one instanced draw.
+    Shader shaderGeometryInstanced = Shader("res/shaderGeometryInstanced.vert", "res/shaderGeometryInstanced.frag");
+
     /// @brief Shader for the geometry pass with mountains.
     Shader shaderGeometryPassMountains = Shader("res/shaderGeometryMountains.vert", "res/shaderGeometryMountains.frag");
 
@@ -38,49 +101,123 @@ public:
     /// @brief Shader for the lighting pass.
     Shader shaderLightingPassNew = Shader("res/shaderLighting.vert", "res/shaderLighting.frag");
 
+    /// @brief Shader scaling the lit image up to the window.
+    Shader upscaleShader = Shader("res/shaderLighting.vert", "res/upscale.frag");
+
     /// @brief Shader for the skybox.
     Shader skyboxShader = Shader("res/skybox.vert", "res/skybox.frag");
 
     /// @brief Shader for the axes crosshair.
     Shader AxesCrosshairShader = Shader("res/axesCrosshair.vert", "res/axesCrosshair.frag");
 
-    /// @brief Texture cube array for shadow mapping.
-    TextureCubeArray textureCubeArray = TextureCubeArray(MAX_LIGHTS);
+    /// @brief Shadow atlas holding the shadow maps of all lights.
+    ShadowAtlas shadowAtlas = ShadowAtlas(ShadowAtlas::defaultSize);
 
     /// @brief G-buffer for deferred rendering.
     gBuffer gbuffer = gBuffer();
 
+    /// @brief The controller picking the resolution the geometry and lighting passes are rendered at.
+    DynamicResolution resolution;
+
     /// @brief Vertex Array Object for rendering a quad.
     unsigned int quadVAO = 0;
 
     /// @brief Vertex Buffer Object for rendering a quad.
     unsigned int quadVBO;
 
+    /// @brief Timer measuring the duration of the render passes.
+    PassTimer passTimer;
+
+    /// @brief The sorted draws of the geometry pass.
+    RenderQueue renderQueue;
+
+    /// @brief The culler selecting the models inside the camera frustum.
+    FrustumCuller culler;
+
+    /// @brief The models visible from the active camera in the current frame.
+    std::vector<Model *> visibleModels;
+
+    /// @brief The shadow casters of every shadow casting light in the current frame.
+    std::vector<std::vector<ShadowCaster>> shadowCasters;
+
+    /// @brief The number of lights whose shadow maps were re-rendered in the last frame.
+    size_t shadowUpdates = 0;
+
+    /// @brief The number of draw calls of the shadow pass in the last frame.
+    size_t shadowDrawCalls = 0;
+
+    /// @brief Shader storage buffer with the (light, face) pair of every shadow instance.
+    unsigned int shadowPairsSSBO;
+
+    /// @brief Flag indicating whether copies of a model are drawn as instances of one draw.
+    /// @details The instanced draws write the IDs of the copies to the stencil with GL_ARB_shader_stencil_export.
+    /// Without the extension every copy is drawn by its own instanced draw, so the outlines keep working.
+    bool instancing = false;
+
+    /// @brief The number of draw calls of the geometry pass in the last frame.
+    size_t geometryDrawCalls = 0;
+
+    /// @brief The persistently mapped ring the frame constants and the instance data of every frame are written to.
+    FrameRing frameRing;
+
+    /// @brief The picker reading the object IDs of the geometry pass back.
+    ObjectPicker picker;
+
+    /// @brief Indirect buffer with the commands of the render queue.
+    unsigned int drawCommandsBuffer;
+
+    /// @brief Indirect buffer with the commands of the shadow pass.
+    unsigned int shadowCommandsBuffer;
+
+    /// @brief The lights assigned to the clusters of the camera frustum in the current frame.
+    LightClusters lightClusters;
+
+    /// @brief Shader storage buffer with the (offset, count) pair of every cluster.
+    unsigned int clusterGridSSBO;
+
+    /// @brief Shader storage buffer with the light indices of all clusters.
+    unsigned int clusterIndicesSSBO;
+
     /// @brief Constructs a Renderer object.
     Renderer();
 
+    /// @brief Starts a frame, reserving its part of the frame ring and uploading the frame constants.
+    /// @details The constants are bound to uniform block 0 and read by all shaders of the scene, so the passes do
+    /// not set the camera, sun and fog uniforms themselves.
+    /// @param models The models of the scene, they bound the size of the instance data.
+    /// @param camera The active camera.
+    /// @param lightingSystem The lighting system holding the sun and the fog.
+    void beginFrame(std::span<Model *const> models, CameraPtr &camera, Lighting &lightingSystem);
+
+    /// @brief Ends a frame, fencing its part of the frame ring.
+    void endFrame();
+
     /// @brief Renders shadows for the given models and camera.
+    /// @details Only the lights that moved, got new atlas tiles or whose casters moved, appeared or disappeared are
+    /// re-rendered, the others keep the shadow map of an earlier frame. Every caster is drawn once, instanced over
+    /// all the (light, face) pairs it has to be rendered into.
     /// @param models The models to render shadows for.
     /// @param camera The camera used for rendering shadows.
-    /// @param lightsCount The number of lights to consider for shadow rendering.
-    void renderShadows(std::unordered_map<size_t, ModelPtr> &models, CameraPtr &camera, size_t lightsCount);
+    /// @param lightingSystem The lighting system holding the lights to render shadows for.
+    void renderShadows(std::span<Model *const> models, CameraPtr &camera, Lighting &lightingSystem);
 
     /// @brief Renders the geometry pass for the given models and cameras.
     /// @param models The models to render.
     /// @param cameras The cameras used for rendering.
     /// @param lightingSystem The lighting system for the scene.
-    void renderGeometry(std::unordered_map<size_t, ModelPtr> &models, std::vector<CameraPtr> &cameras, Lighting &lightingSystem);
+    void renderGeometry(std::span<Model *const> models, std::vector<CameraPtr> &cameras, Lighting &lightingSystem);
 
     /// @brief Renders the lighting pass.
+    /// @details The lights are assigned to the clusters of the camera frustum first, so every pixel only shades
+    /// the lights that can reach it. The lit image is rendered at the resolution of the geometry pass and scaled up
+    /// to the window together with the depth and stencil.
     /// @param camera The camera used for rendering.
     /// @param lightingSystem The lighting system for the scene.
     void renderLighting(CameraPtr &camera, Lighting &lightingSystem);
 
     /// @brief Renders the skybox.
     /// @param skybox The skybox to render.
-    /// @param camera The camera used for rendering.
-    /// @param lightingSystem The lighting system for the scene.
-    void renderSkybox(SkyBox &skybox, CameraPtr &camera, Lighting &lightingSystem);
+    void renderSkybox(SkyBox &skybox);
 
     /// @brief Renders the axes crosshair.
     /// @param crosshair The axes crosshair to render.
@@ -88,8 +225,83 @@ public:
     void renderCrosshair(AxesCrosshair &crosshair, CameraPtr &camera);
 
 private:
+    /// @brief The state the shadow map of every shadow casting light was last rendered with.
+    std::vector<ShadowSlot> shadowSlots_;
+
+    /// @brief The tile size every shadow casting light asked for.
+    std::vector<unsigned int> tileSizes_;
+
+    /// @brief The number of tiles every shadow casting light needs, 1 for spot lights and 6 for point lights.
+    std::vector<unsigned int> tileFaces_;
+
+    /// @brief The atlas tiles of every shadow casting light.
+    std::vector<ShadowTiles> lightTiles_;
+
+    /// @brief The shadow casting lights the atlas was last allocated for.
+    std::vector<size_t> tiledLights_;
+
+    /// @brief The order the tiles are allocated in, the largest first.
+    std::vector<size_t> tileOrder_;
+
+    /// @brief The casters of the light being processed, compared with its slot.
+    std::vector<ShadowSlot::Caster> currentCasters_;
+
+    /// @brief The instanced draws of the shadow pass, the first batchCount_ are used in the current frame.
+    std::vector<ShadowBatch> shadowBatches_;
+
+    /// @brief The number of shadow batches used in the current frame.
+    size_t batchCount_ = 0;
+
+    /// @brief The batch of every set of meshes in the current frame, keyed by the first mesh shared by the copies of
+    /// a caster, or by the caster itself for a custom draw.
+    std::unordered_map<const void *, size_t> batchIndex_;
+
+    /// @brief The index of the instance data of every caster in the current frame.
+    std::unordered_map<Model *, uint32_t> shadowInstanceIndex_;
+
+    /// @brief The instance data of the casters, written to the frame ring.
+    std::vector<InstanceData> shadowInstances_;
+
+    /// @brief The instance groups of the geometry pass, the first groupCount_ are used in the current frame.
+    std::vector<InstanceGroup> instanceGroups_;
+
+    /// @brief The number of instance groups used in the current frame.
+    size_t groupCount_ = 0;
+
+    /// @brief The group of every set of meshes in the current frame, keyed by the first mesh shared by the copies.
+    std::unordered_map<const Mesh *, size_t> groupIndex_;
+
+    /// @brief The instances of all groups, written to the frame ring.
+    std::vector<InstanceData> instances_;
+
+    /// @brief The pairs of all batches, uploaded to the shadow pair buffer.
+    std::vector<glm::uvec2> shadowPairs_;
+
+    /// @brief The indirect commands of the shadow batches with pooled meshes.
+    std::vector<DrawCommand> shadowCommands_;
+
+    /// @brief The width the deferred passes are rendered at in the current frame.
+    int renderWidth_ = 0;
+
+    /// @brief The height the deferred passes are rendered at in the current frame.
+    int renderHeight_ = 0;
+
     /// @brief Renders a quad.
     void renderQuad();
+
+    /// @brief Picks the tile size of every shadow casting light from its screen coverage and reallocates the atlas
+    /// when a size changes.
+    /// @param camera The camera the coverage is measured from.
+    /// @param lightingSystem The lighting system, its light data receives the tiles.
+    void assignShadowTiles(CameraPtr &camera, Lighting &lightingSystem);
+
+    /// @brief Fills the render queue with the draws of the geometry pass and sorts it.
+    /// @param models The models to render.
+    /// @param camera The camera the depth of the draws is measured from.
+    void buildRenderQueue(std::span<Model *const> models, CameraPtr &camera);
+
+    /// @brief Submits the sorted render queue, changing the shader, material and stencil state only between groups.
+    void submitRenderQueue();
 };
 
 #endif //PROJECT_RENDERER_H
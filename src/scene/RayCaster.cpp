@@ -0,0 +1,67 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <algorithm>
+
+#include "glm/geometric.hpp"
+#include "glm/matrix.hpp"
+
+#include "RayCaster.h"
+#include "../graphics/models/Model.h"
+#include "../benchmark/Profiler.h"
+
+bool RayCaster::cast(std::span<Model *const> models, const glm::vec3 &origin, const glm::vec3 &direction,
+                     RayHit &hit, float maxDistance) {
+    PROFILE_ZONE("RayCaster::cast");
+    glm::vec3 inverseDirection = 1.0f / direction;
+    candidates_.clear();
+    for (Model *model: models) {
+        if (model->hidden() || model->selectionMode) {
+            continue;
+        }
+        float enter;
+        if (model->getWorldBounds().intersectRay(origin, inverseDirection, maxDistance, enter)) {
+            candidates_.push_back({model, enter});
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate &a, const Candidate &b) { return a.enter < b.enter; });
+
+    hit = RayHit();
+    float distance = maxDistance;
+    glm::mat4 hitInverse(1.0f);
+    for (auto &candidate: candidates_) {
+        if (candidate.enter > distance) {
+            break;
+        }
+        // the model matrix is affine, so the distances along the transformed ray stay world distances
+        glm::mat4 inverse = glm::inverse(candidate.model->getModelMatrixQuat());
+        glm::vec3 localOrigin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+        glm::vec3 localDirection = glm::mat3(inverse) * direction;
+        for (size_t i = 0; i < candidate.model->meshes.size(); i++) {
+            uint32_t triangle;
+            if (candidate.model->meshes[i]->bvh.intersect(localOrigin, localDirection, distance, triangle)) {
+                hit.model = candidate.model;
+                hit.mesh = i;
+                hit.triangle = triangle;
+                hitInverse = inverse;
+            }
+        }
+    }
+    if (hit.model == nullptr) {
+        return false;
+    }
+
+    hit.distance = distance;
+    hit.point = origin + distance * direction;
+    const Mesh &mesh = *hit.model->meshes[hit.mesh];
+    glm::vec3 a = mesh.vertices[mesh.indices[3 * hit.triangle]].position;
+    glm::vec3 b = mesh.vertices[mesh.indices[3 * hit.triangle + 1]].position;
+    glm::vec3 c = mesh.vertices[mesh.indices[3 * hit.triangle + 2]].position;
+    hit.normal = glm::normalize(glm::transpose(glm::mat3(hitInverse)) * glm::cross(b - a, c - a));
+    if (glm::dot(hit.normal, direction) > 0.0f) {
+        hit.normal = -hit.normal;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+/// @file RayCaster.h
+/// @brief This file contains the definition of the RayHit structure and the RayCaster class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_RAYCASTER_H
+#define PROJECT_RAYCASTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "glm/vec3.hpp"
+
+#define RAY_CASTER_MAX_DISTANCE 1000.0f ///< The distance beyond which rays hit nothing.
+
+class Model;
+
+/// @struct RayHit
+/// @brief The closest surface hit by a ray.
+struct RayHit {
+    Model *model = nullptr; ///< The hit model, nullptr if nothing was hit.
+    size_t mesh = 0; ///< The index of the hit mesh in the meshes of the model.
+    uint32_t triangle = 0; ///< The index of the hit triangle in the indices of the mesh, divided by three.
+    float distance = 0.0f; ///< The distance from the origin of the ray to the hit.
+    glm::vec3 point = glm::vec3(0.0f); ///< The hit point in world space.
+    glm::vec3 normal = glm::vec3(0.0f); ///< The normal of the hit triangle in world space, facing the origin of the ray.
+};
+
+/// @class RayCaster
+/// @brief The RayCaster class finds the surface of the scene hit by a ray on the CPU, without touching the GPU.
+/// @details The world bounds of the models are tested first and the hit boxes are visited from the nearest one, so
+/// models behind the closest hit are skipped. The ray is then moved into the space of each model and tested against
+/// the MeshBVH of every mesh, which the copies of a model share.
+class RayCaster {
+public:
+    /// @brief Finds the closest surface hit by a ray.
+    /// @details Hidden models and models in selection mode, which follow the camera, are ignored.
+    /// @param models The models to test.
+    /// @param origin The origin of the ray in world space.
+    /// @param direction The direction of the ray in world space, normalized.
+    /// @param hit Receives the hit.
+    /// @param maxDistance The distance beyond which surfaces are ignored.
+    /// @return True if a surface was hit.
+    bool cast(std::span<Model *const> models, const glm::vec3 &origin, const glm::vec3 &direction, RayHit &hit,
+              float maxDistance = RAY_CASTER_MAX_DISTANCE);
+
+private:
+    /// @struct Candidate
+    /// @brief A model whose world bounds the ray hits.
+    struct Candidate {
+        Model *model; ///< The model.
+        float enter; ///< The distance at which the ray enters its bounds.
+    };
+
+    /// @brief The models whose bounds the current ray hits, kept to reuse the memory.
+    std::vector<Candidate> candidates_;
+};
+
+#endif //PROJECT_RAYCASTER_H
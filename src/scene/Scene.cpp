@@ -14,8 +14,10 @@
 #include "../graphics/models/Terrain.h"
 #include "../class_factory/ClassFactory.h"
 #include "../window/Events.h"
+#include "../window/InputTrace.h"
 #include "../graphics/models/TVModel.h"
 #include "../loaders/FileSaver.h"
+#include "../benchmark/Profiler.h"
 
 void registerClasses() {
     REGISTER_CLASS(Model);
@@ -105,6 +107,7 @@ void Scene::saveScene() {
 }
 
 void Scene::loadScene() {
+    PROFILE_ZONE("Scene::loadScene");
     FileSaver fileSaver(READ, sceneNameBin);
     if (!fileSaver.getStatus()) {
         std::cerr << "Failed to open file for reading!" << std::endl;
@@ -139,12 +142,12 @@ void Scene::loadScene() {
         if (modelsLoaded.find(path) == modelsLoaded.end()) {
             modelsLoaded[path] = ID;
             std::cout << "Creating original object with ID: " << ID << std::endl;
-            models[ID] = ClassFactory::instance().create(className, path, ID);
+            addModel(ClassFactory::instance().create(className, path, ID));
             std::cout << "Object with path " << path << " loaded\n" << std::endl;
         } else {
             std::cout << "Object with path " << path << " already loaded" << std::endl;
             std::cout << "Creating " << ID << " copy of object with ID " << modelsLoaded[path] << std::endl;
-            models[ID] = models[modelsLoaded[path]]->copy(ID);
+            addModel(models[modelsLoaded[path]]->copy(ID));
             models[ID]->parent = models[modelsLoaded[path]];
         }
         models[ID]->className = className;
@@ -253,7 +256,7 @@ void Scene::loadScene() {
             }
         }
 
-        animationPoints.push_back(animationPoint);
+        addAnimationPoint(animationPoint);
         animationPoints.back()->position = position;
         animationPoints.back()->quatRotation = quatRotation;
         animationPoints.back()->className = className;
@@ -263,13 +266,22 @@ void Scene::loadScene() {
     std::cout << "\nScene loaded from file successfully\n" << std::endl;
 }
 
+// a replay loads the recorded scenes but must never write the files the recorded dialogs point to
+static bool replayingTrace() {
+    return Events::trace != nullptr && Events::trace->mode == READ;
+}
+
 void Scene::update(float deltaTime) {
+    PROFILE_ZONE("Scene::update");
+    TVScreen::animationTime += deltaTime;
     if (Events::keyboardJustPressed(GLFW_KEY_ESCAPE)) {
         Window::setWindowShouldClose(true);
     }
     if (Events::keyboardJustPressed(GLFW_KEY_F1)) {
         std::string sceneName = Window::openFileSaverDialog();
-        if (!sceneName.empty()) {
+        if (!sceneName.empty() && replayingTrace()) {
+            std::cout << "Replaying input trace, scene not saved to " << sceneName << std::endl;
+        } else if (!sceneName.empty()) {
             this->sceneNameBin = sceneName;
             saveScene();
         }
@@ -277,20 +289,31 @@ void Scene::update(float deltaTime) {
     if (Events::keyboardJustPressed(GLFW_KEY_F2)) {
         std::string sceneName = Window::openFileSelectionDialog();
         if (!sceneName.empty()) {
-            saveScene();
+            if (!replayingTrace()) {
+                saveScene();
+            }
             this->sceneNameBin = sceneName;
             loadScene();
         }
     }
+    if (Events::keyboardJustPressed(GLFW_KEY_F3)) {
+        Profiler::dump();
+    }
+    if (Events::keyboardJustPressed(GLFW_KEY_F4)) {
+        renderer.culler.frozen = !renderer.culler.frozen;
+        std::cout << "Frustum frozen: " << renderer.culler.frozen << std::endl;
+    }
 
     if (Events::keyboardJustPressed(GLFW_KEY_TAB)) {
         Events::cursorLocked = !Events::cursorLocked;
         std::cout << "Cursor locked: " << Events::cursorLocked << std::endl;
-        if (Events::cursorLocked) {
-            glfwSetCursorPos(Window::window, (double) Window::WIDTH / 2, (double) Window::HEIGHT / 2);
-            glfwSetInputMode(Window::window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        } else {
-            glfwSetInputMode(Window::window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        if (!Window::headless) {
+            if (Events::cursorLocked) {
+                glfwSetCursorPos(Window::window, (double) Window::WIDTH / 2, (double) Window::HEIGHT / 2);
+                glfwSetInputMode(Window::window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+            } else {
+                glfwSetInputMode(Window::window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+            }
         }
     }
 
@@ -306,9 +329,10 @@ void Scene::update(float deltaTime) {
                 objCurrID = freeIDs[0];
                 freeIDs[0]++;
             }
-            models[objCurrID] = std::make_shared<Model>(szFile, objCurrID);
+            ModelPtr model = std::make_shared<Model>(szFile, objCurrID);
+            model->position = placementPoint(model.get());
+            addModel(model);
             models[objCurrID]->className = GET_CLASS_NAME(Model);
-            models[objCurrID]->position = cameras[currCamera]->position + 3.0f * cameras[currCamera]->front;
         } else {
             std::cout << "File selection cancelled." << std::endl;
         }
@@ -325,9 +349,10 @@ void Scene::update(float deltaTime) {
                 objCurrID = freeIDs[0];
                 freeIDs[0]++;
             }
-            models[objCurrID] = std::make_shared<Terrain>(szFile, objCurrID);
+            ModelPtr model = std::make_shared<Terrain>(szFile, objCurrID);
+            model->position = placementPoint(model.get());
+            addModel(model);
             models[objCurrID]->className = GET_CLASS_NAME(Terrain);
-            models[objCurrID]->position = cameras[currCamera]->position + 3.0f * cameras[currCamera]->front;
         } else {
             std::cout << "File selection cancelled." << std::endl;
         }
@@ -344,8 +369,7 @@ void Scene::update(float deltaTime) {
             objCurrID = freeIDs[0];
             freeIDs[0]++;
         }
-        lightingSystem.addPointLight(objCurrID, cameras[currCamera]->position + 3.0f * cameras[currCamera]->front,
-                                     glm::vec3(red, green, blue));
+        lightingSystem.addPointLight(objCurrID, placementPoint(nullptr), glm::vec3(red, green, blue));
     }
     if (Events::keyboardJustPressed(GLFW_KEY_4)) {
         float red = lightingSystem.getRandomColor();
@@ -360,8 +384,8 @@ void Scene::update(float deltaTime) {
             objCurrID = freeIDs[0];
             freeIDs[0]++;
         }
-        lightingSystem.addSpotLight(objCurrID, cameras[currCamera]->position + 3.0f * cameras[currCamera]->front,
-                                    glm::vec3(red, green, blue), glm::vec4(-1.0, 0.0, 0.0, 40.0));
+        lightingSystem.addSpotLight(objCurrID, placementPoint(nullptr), glm::vec3(red, green, blue),
+                                    glm::vec4(-1.0, 0.0, 0.0, 40.0));
     }
     if (Events::keyboardJustPressed(GLFW_KEY_5)) {
         size_t objCurrID;
@@ -372,9 +396,10 @@ void Scene::update(float deltaTime) {
             objCurrID = freeIDs[0];
             freeIDs[0]++;
         }
-        models[objCurrID] = std::make_shared<TVModel>("res/tv/tv.obj", objCurrID);
+        ModelPtr model = std::make_shared<TVModel>("res/tv/tv.obj", objCurrID);
+        model->position = placementPoint(model.get());
+        addModel(model);
         models[objCurrID]->className = GET_CLASS_NAME(TVModel);
-        models[objCurrID]->position = cameras[currCamera]->position + 3.0f * cameras[currCamera]->front;
         TVs.push_back(std::dynamic_pointer_cast<TVModel>(models[objCurrID]));
     }
     if (Events::keyboardJustPressed(GLFW_KEY_6)) {
@@ -387,8 +412,7 @@ void Scene::update(float deltaTime) {
             freeIDs[0]++;
         }
         cameras.push_back(
-                std::make_shared<Camera>(objCurrID, cameras[currCamera]->position + 3.0f * cameras[currCamera]->front,
-                                         60.0f));
+                std::make_shared<Camera>(objCurrID, placementPoint(nullptr), 60.0f));
         cameras.back()->Xangle = cameras[currCamera]->Xangle;
         cameras.back()->Yangle = cameras[currCamera]->Yangle;
         cameras.back()->Zangle = cameras[currCamera]->Zangle;
@@ -414,10 +438,10 @@ void Scene::update(float deltaTime) {
         } else {
             animationPoint = std::make_shared<AnimationPoint>("res/animation/animation_point.obj", objCurrID);
         }
-        animationPoints.push_back(animationPoint);
+        animationPoint->quatRotation = cameras[currCamera]->quatRotation;
+        animationPoint->position = placementPoint(animationPoint.get());
+        addAnimationPoint(animationPoint);
         animationPoints.back()->className = GET_CLASS_NAME(AnimationPoint);
-        animationPoints.back()->position = cameras[currCamera]->position + 3.0f * cameras[currCamera]->front;
-        animationPoints.back()->quatRotation = cameras[currCamera]->quatRotation;
     }
 
     if (Events::keyboardPressed(GLFW_KEY_LEFT_CONTROL)) {
@@ -497,46 +521,20 @@ void Scene::update(float deltaTime) {
         cameras[currCamera]->lock = !cameras[currCamera]->lock;
     }
 
-    if (Events::mouseJustPressed(GLFW_MOUSE_BUTTON_LEFT)) {
-        unsigned char pixelID;
-
-        glReadPixels((int) (Window::WIDTH / 2), (int) (Window::HEIGHT / 2), 1, 1,
-                     GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, &pixelID);
-        if (pixelID == 0) { // background was clicked
-            std::cout << "clicked on background" << std::endl;
-        } else { // object was clicked
-
-            std::cout << "clicked on object with ID: " << (int) pixelID << std::endl;
-
-            if (models.find(pixelID) != models.end()) {
-                models[pixelID]->cameraDistance = glm::length(
-                        models[pixelID]->position - cameras[currCamera]->position);
-                models[pixelID]->selectionMode = !models[pixelID]->selectionMode;
-            }
-            for (auto &light: lightingSystem.lights) {
-                if (light->ID == pixelID) {
-                    light->cameraDistance = glm::length(light->position - cameras[currCamera]->position);
-                    light->selectionMode = !light->selectionMode;
-                }
-            }
-            for (auto &camera: cameras) {
-                if (camera->ID == pixelID) {
-                    std::cout << "Camera with ID " << camera->ID << " selected" << std::endl;
-                    camera->cameraDistance = glm::length(camera->position - cameras[currCamera]->position);
-                    camera->selectionMode = !camera->selectionMode;
-                }
-            }
-            for (auto &animationPoint: animationPoints) {
-                if (animationPoint->ID == pixelID) {
-                    animationPoint->cameraDistance = glm::length(
-                            animationPoint->position - cameras[currCamera]->position);
-                    animationPoint->selectionMode = !animationPoint->selectionMode;
-                }
-            }
-
+    // the picks are resolved a few frames after they were requested, without waiting for the GPU
+    PickResult pick;
+    while (renderer.picker.poll(pick)) {
+        if (pick.action == PICK_SELECT) {
+            select(pick.ID);
+        } else {
+            interact(pick.ID);
         }
     }
 
+    if (Events::mouseJustPressed(GLFW_MOUSE_BUTTON_LEFT)) {
+        renderer.picker.request(PICK_SELECT);
+    }
+
     if (Events::keyboardJustPressed(GLFW_KEY_RIGHT)) {
         cameras[currCamera++]->active = false;
         currCamera %= cameras.size();
@@ -545,24 +543,7 @@ void Scene::update(float deltaTime) {
     }
 
     if (Events::keyboardJustPressed(GLFW_KEY_E)) {
-
-        unsigned char pixelID;
-        glReadPixels((int) (Window::WIDTH / 2), (int) (Window::HEIGHT / 2), 1, 1,
-                     GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, &pixelID);
-        std::cout << "\nInteracted with object with ID: " << (int) pixelID << "\n" << std::endl;
-        if (models.find(pixelID) != models.end()) {
-            models[pixelID]->isInteracted = true;
-        }
-        for (auto &light: lightingSystem.lights) {
-            if (light->ID == pixelID) {
-                light->isInteracted = true;
-            }
-        }
-        for (auto &point: animationPoints) {
-            if (point->ID == pixelID) {
-                point->isInteracted = true;
-            }
-        }
+        renderer.picker.request(PICK_INTERACT);
     }
 
     if (Events::keyboardJustPressed(GLFW_KEY_F)) {
@@ -589,9 +570,6 @@ void Scene::update(float deltaTime) {
 
     for (auto &pair: models) {
         auto model = pair.second;
-        model->projection = cameras[currCamera]->getProjection();
-        model->view = cameras[currCamera]->getView();
-
         if (model->selectionMode) {
             if (model->rotationMode) {
                 model->applyRotation((float) Events::mouseDeltaX / (float) Window::WIDTH, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -618,7 +596,7 @@ void Scene::update(float deltaTime) {
                     freeIDs[0]++;
                 }
                 ModelPtr newModel = model->copy(objCurrID);
-                models[objCurrID] = newModel;
+                addModel(newModel);
                 if (model->parent == nullptr) {
                     newModel->parent = model;
                 } else {
@@ -628,7 +606,7 @@ void Scene::update(float deltaTime) {
             }
             if (Events::keyboardJustPressed(GLFW_KEY_BACKSPACE)) {
                 freeIDs.push_back(model->ID);
-                models.erase(model->ID);
+                removeModel(model->ID);
                 if (model->className == GET_CLASS_NAME(TVModel)) {
                     TVs.erase(std::find(TVs.begin(), TVs.end(), std::dynamic_pointer_cast<TVModel>(model)));
                 }
@@ -692,8 +670,6 @@ void Scene::update(float deltaTime) {
     AnimationPointPtr deletedAnimationPoint = nullptr;
     AnimationPointPtr copiedAnimationPoint = nullptr;
     for (auto &animationPoint: animationPoints) {
-        animationPoint->projection = cameras[currCamera]->getProjection();
-        animationPoint->view = cameras[currCamera]->getView();
         if (animationPoint->selectionMode) {
             animationPoint->position =
                     cameras[currCamera]->position + animationPoint->cameraDistance * cameras[currCamera]->front;
@@ -729,26 +705,154 @@ void Scene::update(float deltaTime) {
 
     }
     if (copiedAnimationPoint != nullptr)
-        animationPoints.push_back(copiedAnimationPoint);
+        addAnimationPoint(copiedAnimationPoint);
     if (deletedAnimationPoint != nullptr)
-        animationPoints.erase(std::find(animationPoints.begin(), animationPoints.end(), deletedAnimationPoint));
+        removeAnimationPoint(deletedAnimationPoint);
 }
 
-void Scene::draw(int fps) {
+void Scene::addModel(const ModelPtr &model) {
+    auto it = models.find(model->ID);
+    if (it != models.end()) {
+        removeFromRenderList(it->second.get());
+    }
+    models[model->ID] = model;
+    renderList.push_back(model.get());
+}
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    std::unordered_map<size_t, ModelPtr> modelsCopy = models;
+void Scene::removeModel(size_t ID) {
+    auto it = models.find(ID);
+    if (it == models.end()) {
+        return;
+    }
+    removeFromRenderList(it->second.get());
+    models.erase(it);
+}
+
+void Scene::addAnimationPoint(const AnimationPointPtr &animationPoint) {
+    animationPoints.push_back(animationPoint);
+    renderList.push_back(animationPoint.get());
+}
+
+void Scene::removeAnimationPoint(const AnimationPointPtr &animationPoint) {
+    removeFromRenderList(animationPoint.get());
+    animationPoints.erase(std::find(animationPoints.begin(), animationPoints.end(), animationPoint));
+}
+
+void Scene::removeFromRenderList(Model *model) {
+    auto it = std::find(renderList.begin(), renderList.end(), model);
+    if (it != renderList.end()) {
+        // the order does not matter, the renderer sorts the draws itself
+        *it = renderList.back();
+        renderList.pop_back();
+    }
+}
+
+glm::vec3 Scene::placementPoint(Model *model) {
+    CameraPtr &camera = cameras[currCamera];
+    RayHit hit;
+    if (!rayCaster.cast(renderList, camera->position, camera->front, hit)) {
+        return camera->position + 3.0f * camera->front;
+    }
+    if (model == nullptr || model->bounds.empty) {
+        return hit.point + SCENE_PLACEMENT_OFFSET * hit.normal;
+    }
+
+    // the origin is lifted by how far the rotated and scaled bounds reach behind it along the normal
+    glm::mat3 linear = glm::mat3(model->getModelMatrixQuat());
+    glm::vec3 center = (model->bounds.min + model->bounds.max) * 0.5f;
+    glm::vec3 extents = model->bounds.max - center;
+    float below = -glm::dot(hit.normal, linear * center);
+    for (int axis = 0; axis < 3; axis++) {
+        below += std::abs(glm::dot(hit.normal, linear[axis])) * extents[axis];
+    }
+    return hit.point + (below + SCENE_PLACEMENT_OFFSET) * hit.normal;
+}
+
+void Scene::select(size_t ID) {
+    if (ID == 0) { // background was clicked
+        std::cout << "clicked on background" << std::endl;
+        return;
+    }
+    std::cout << "clicked on object with ID: " << ID << std::endl;
+
+    if (models.find(ID) != models.end()) {
+        models[ID]->cameraDistance = glm::length(models[ID]->position - cameras[currCamera]->position);
+        models[ID]->selectionMode = !models[ID]->selectionMode;
+    }
+    for (auto &light: lightingSystem.lights) {
+        if (light->ID == ID) {
+            light->cameraDistance = glm::length(light->position - cameras[currCamera]->position);
+            light->selectionMode = !light->selectionMode;
+        }
+    }
+    for (auto &camera: cameras) {
+        if (camera->ID == ID) {
+            std::cout << "Camera with ID " << camera->ID << " selected" << std::endl;
+            camera->cameraDistance = glm::length(camera->position - cameras[currCamera]->position);
+            camera->selectionMode = !camera->selectionMode;
+        }
+    }
     for (auto &animationPoint: animationPoints) {
-        modelsCopy[animationPoint->ID] = animationPoint;
+        if (animationPoint->ID == ID) {
+            animationPoint->cameraDistance = glm::length(animationPoint->position - cameras[currCamera]->position);
+            animationPoint->selectionMode = !animationPoint->selectionMode;
+        }
+    }
+}
+
+void Scene::interact(size_t ID) {
+    std::cout << "\nInteracted with object with ID: " << ID << "\n" << std::endl;
+    if (models.find(ID) != models.end()) {
+        models[ID]->isInteracted = true;
+    }
+    for (auto &light: lightingSystem.lights) {
+        if (light->ID == ID) {
+            light->isInteracted = true;
+        }
+    }
+    for (auto &point: animationPoints) {
+        if (point->ID == ID) {
+            point->isInteracted = true;
+        }
+    }
+}
 
+void Scene::draw() {
+    PROFILE_ZONE("Scene::draw");
+    renderer.passTimer.nextFrame();
+    double gpuTime = 0.0;
+    for (double time: renderer.passTimer.gpuTimes) {
+        gpuTime += time;
     }
+    renderer.resolution.update(gpuTime);
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    renderer.beginFrame(renderList, cameras[currCamera], lightingSystem);
 
-    renderer.renderShadows(modelsCopy, cameras[currCamera], lightingSystem.lights.size());
-    renderer.renderGeometry(modelsCopy, cameras, lightingSystem);
+    renderer.passTimer.begin(PASS_SHADOWS);
+    renderer.renderShadows(renderList, cameras[currCamera], lightingSystem);
+    renderer.passTimer.end(PASS_SHADOWS);
+
+    renderer.passTimer.begin(PASS_GEOMETRY);
+    renderer.renderGeometry(renderList, cameras, lightingSystem);
+    renderer.passTimer.end(PASS_GEOMETRY);
+
+    renderer.passTimer.begin(PASS_LIGHTING);
     renderer.renderLighting(cameras[currCamera], lightingSystem);
-    renderer.renderSkybox(skybox, cameras[currCamera], lightingSystem);
+    renderer.passTimer.end(PASS_LIGHTING);
+
+    renderer.passTimer.begin(PASS_SKYBOX);
+    renderer.renderSkybox(skybox);
+    renderer.passTimer.end(PASS_SKYBOX);
+
+    renderer.passTimer.begin(PASS_CROSSHAIR);
     renderer.renderCrosshair(axesCrosshair, cameras[currCamera]);
-    hudRenderer.drawDebug(fps);
+    renderer.passTimer.end(PASS_CROSSHAIR);
+
+    renderer.passTimer.begin(PASS_HUD);
+    hudRenderer.drawDebug(frameStats, renderer);
+    renderer.passTimer.end(PASS_HUD);
+    renderer.endFrame();
 
     Window::swapBuffers();
     Events::pullEvents();
@@ -20,6 +20,10 @@
 #include "../animation/AnimationPoint.h"
 #include "../animation/Animator.h"
 #include "../graphics/models/TVModel.h"
+#include "../benchmark/FrameStats.h"
+#include "RayCaster.h"
+
+#define SCENE_PLACEMENT_OFFSET 0.05f ///< The gap kept between a placed object and the surface it is placed on.
 
 /// @class Scene
 /// @brief The Scene class manages all elements within a scene, including models, cameras, animations, lighting, and rendering.
@@ -50,6 +54,10 @@ public:
     /// @brief A vector of animation point pointers.
     std::vector<AnimationPointPtr> animationPoints;
 
+    /// @brief The models and animation points passed to the renderer, kept in sync by the add and remove methods.
+    /// @details The objects are owned by models and animationPoints, so the list holds plain pointers.
+    std::vector<Model *> renderList;
+
     /// @brief The lighting system for the scene.
     Lighting lightingSystem = Lighting();
 
@@ -65,6 +73,12 @@ public:
     /// @brief The skybox for the scene.
     SkyBox skybox = SkyBox();
 
+    /// @brief The frame time statistics shown in the HUD.
+    FrameStats frameStats;
+
+    /// @brief The ray query finding the surface new objects are placed on.
+    RayCaster rayCaster;
+
     /// @brief Constructs a Scene object with the specified scene name.
     /// @param sceneName The name of the scene. Default is "default.bin".
     Scene(std::string sceneName = "default.bin");
@@ -80,8 +94,43 @@ public:
     void update(float deltaTime);
 
     /// @brief Draws the scene, including HUD elements.
-    /// @param fps The current frames per second to display in the HUD.
-    void draw(int fps);
+    void draw();
+
+    /// @brief Adds a model to the scene, replacing the model with the same ID.
+    /// @param model The model to add.
+    void addModel(const ModelPtr &model);
+
+    /// @brief Removes a model from the scene.
+    /// @param ID The ID of the model.
+    void removeModel(size_t ID);
+
+    /// @brief Adds an animation point to the scene.
+    /// @param animationPoint The animation point to add.
+    void addAnimationPoint(const AnimationPointPtr &animationPoint);
+
+    /// @brief Removes an animation point from the scene.
+    /// @param animationPoint The animation point to remove.
+    void removeAnimationPoint(const AnimationPointPtr &animationPoint);
+
+private:
+    /// @brief Removes an object from the render list.
+    /// @param model The object to remove.
+    void removeFromRenderList(Model *model);
+
+    /// @brief Gets the position a new object is placed at, on the surface under the crosshair.
+    /// @details A model is lifted along the normal of the surface by the extent of its rotated and scaled bounds, so
+    /// it rests on the surface instead of sinking into it. Lights and cameras only keep a small gap to the surface.
+    /// @param model The model to place with its rotation and scale set, nullptr for lights and cameras.
+    /// @return The position, 3 units in front of the camera if the camera ray hits nothing.
+    glm::vec3 placementPoint(Model *model);
+
+    /// @brief Toggles the selection of the object with the given ID, resolved from a pick.
+    /// @param ID The ID of the object, 0 for the background.
+    void select(size_t ID);
+
+    /// @brief Interacts with the object with the given ID, resolved from a pick.
+    /// @param ID The ID of the object, 0 for the background.
+    void interact(size_t ID);
 };
 
 #endif //PROJECT_SCENE_H
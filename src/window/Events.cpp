@@ -16,6 +16,7 @@ double Events::mouseDeltaY = 0.0;
 double Events::scrollY = 0;
 bool Events::cursorStarted = false;
 bool Events::cursorLocked = false;
+InputTrace *Events::trace = nullptr;
 
 
 void cursorPositionCallback(GLFWwindow* window, double xpos, double ypos){
@@ -51,6 +52,11 @@ void scrollCallback(GLFWwindow* window, double xoffset, double yoffset){
 
 void windowSizeCallback(GLFWwindow* window, int width, int height){
     glViewport(0, 0, width, height);
+    // a minimized window reports zero, keep the last size for the render targets
+    if (width > 0 && height > 0) {
+        Window::WIDTH = width;
+        Window::HEIGHT = height;
+    }
 }
 
 int Events::initialize(){
@@ -59,6 +65,10 @@ int Events::initialize(){
 
     memset(Events::keys, 0, (GLFW_KEY_LAST + GLFW_MOUSE_BUTTON_LAST) * sizeof(wchar_t));
 
+    if (Window::headless) {
+        return 0;
+    }
+
     // callbacks
     glfwSetCursorPosCallback(window, cursorPositionCallback);
     glfwSetKeyCallback(window, keyCallback);
@@ -74,7 +84,9 @@ void Events::pullEvents(){
     mouseDeltaX = 0.0;
     mouseDeltaY = 0.0;
     scrollY = 0;
-    glfwPollEvents();
+    if (!Window::headless) {
+        glfwPollEvents();
+    }
 }
 
 bool Events::keyboardPressed(int key) {
@@ -8,6 +8,8 @@
 
 #include "Window.h"
 
+class InputTrace;
+
 /// @class Events
 /// @brief The Events class handles input events such as keyboard and mouse actions.
 /// @details This class provides methods to initialize event handling, pull events, and check the state of keyboard and mouse inputs.
@@ -37,6 +39,9 @@ public:
     /// @brief Flag indicating whether the cursor is locked.
     static bool cursorLocked;
 
+    /// @brief The input trace being recorded or replayed, nullptr if none.
+    static InputTrace *trace;
+
     /// @brief Initializes the event handling system.
     /// @return An integer representing the success or failure of the initialization.
     static int initialize();
@@ -0,0 +1,172 @@
+//
+// Created by korikmat on 17.10.2026.
+//
+
+#include <GLFW/glfw3.h>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "InputTrace.h"
+#include "Events.h"
+#include "Window.h"
+
+#define KEYS_COUNT (GLFW_KEY_LAST + GLFW_MOUSE_BUTTON_LAST)
+
+InputTrace::InputTrace(bool mode, std::string const &fileName) : mode(mode), file_(mode, fileName),
+                                                                  keys_(KEYS_COUNT, 0) {
+    if (!file_.getStatus()) {
+        std::cerr << "Failed to open input trace " << fileName << std::endl;
+        return;
+    }
+
+    size_t magic = TRACE_MAGIC;
+    size_t version = TRACE_VERSION;
+    if (mode == WRITE) {
+        width_ = Window::WIDTH;
+        height_ = Window::HEIGHT;
+        file_.saveToFile(magic);
+        file_.saveToFile(version);
+        file_.saveToFile(width_);
+        file_.saveToFile(height_);
+        valid_ = true;
+        std::cout << "Recording input trace to " << fileName << std::endl;
+        return;
+    }
+
+    // the header has a fixed size, so a file that is not a trace can not make the reads allocate garbage sizes
+    try {
+        file_.loadFromFile(magic);
+        file_.loadFromFile(version);
+        if (magic != TRACE_MAGIC || version != TRACE_VERSION) {
+            std::cerr << "File " << fileName << " is not a supported input trace" << std::endl;
+            return;
+        }
+        file_.loadFromFile(width_);
+        file_.loadFromFile(height_);
+    } catch (const std::exception &) {
+        std::cerr << "File " << fileName << " is not a supported input trace" << std::endl;
+        return;
+    }
+    valid_ = true;
+
+    // dialogs opened before the first frame (e.g. the startup scene selection)
+    nextTag_ = readTag();
+    readDialogs();
+    std::cout << "Replaying input trace " << fileName << std::endl;
+}
+
+bool InputTrace::getStatus() {
+    return valid_;
+}
+
+void InputTrace::record(float deltaTime) {
+    if (!valid_ || mode != WRITE) {
+        return;
+    }
+    file_.saveToFile((size_t) TRACE_FRAME);
+    file_.saveToFile(deltaTime);
+    file_.saveToFile(Events::mouseDeltaX);
+    file_.saveToFile(Events::mouseDeltaY);
+    file_.saveToFile(Events::scrollY);
+
+    // pairs of (key, state) for the keys that changed since the previous frame
+    std::vector<size_t> changes;
+    for (size_t key = 0; key < KEYS_COUNT; key++) {
+        if (Events::keys[key] != keys_[key]) {
+            keys_[key] = Events::keys[key];
+            changes.push_back(key);
+            changes.push_back((size_t) keys_[key]);
+        }
+    }
+    file_.saveToFile(changes);
+    framesCount++;
+}
+
+bool InputTrace::replay(float &deltaTime) {
+    if (!valid_ || mode != READ || nextTag_ != TRACE_FRAME) {
+        return false;
+    }
+    float frameDeltaTime;
+    double mouseDeltaX, mouseDeltaY, scrollY;
+    std::vector<size_t> changes;
+    try {
+        file_.loadFromFile(frameDeltaTime);
+        file_.loadFromFile(mouseDeltaX);
+        file_.loadFromFile(mouseDeltaY);
+        file_.loadFromFile(scrollY);
+        file_.loadFromFile(changes);
+    } catch (const std::exception &) {
+        // a recording that was interrupted mid-frame ends before its last record
+        std::cerr << "Input trace ends with a truncated frame after " << framesCount << " frames" << std::endl;
+        nextTag_ = 0;
+        return false;
+    }
+    deltaTime = frameDeltaTime;
+
+    for (size_t i = 0; i + 1 < changes.size(); i += 2) {
+        if (changes[i] < KEYS_COUNT) {
+            keys_[changes[i]] = (wchar_t) changes[i + 1];
+        }
+    }
+    // the whole state is restored, so nothing from the live window leaks into the replay
+    std::memcpy(Events::keys, keys_.data(), KEYS_COUNT * sizeof(wchar_t));
+
+    // mouse deltas are divided by the window size in Scene::update, keep the rotations identical
+    Events::mouseDeltaX = width_ ? mouseDeltaX * Window::WIDTH / (double) width_ : mouseDeltaX;
+    Events::mouseDeltaY = height_ ? mouseDeltaY * Window::HEIGHT / (double) height_ : mouseDeltaY;
+    Events::scrollY = scrollY;
+
+    nextTag_ = readTag();
+    dialogs_.clear();
+    readDialogs();
+    framesCount++;
+    return true;
+}
+
+void InputTrace::recordDialog(std::string path) {
+    if (!valid_ || mode != WRITE) {
+        return;
+    }
+    file_.saveToFile((size_t) TRACE_DIALOG);
+    file_.saveToFile(path);
+}
+
+std::string InputTrace::replayDialog() {
+    if (dialogs_.empty()) {
+        std::cerr << "Input trace has no recorded dialog for frame " << framesCount << std::endl;
+        return "";
+    }
+    std::string path = dialogs_.front();
+    dialogs_.pop_front();
+    return path;
+}
+
+size_t InputTrace::readTag() {
+    if (file_.isEnd()) {
+        return 0;
+    }
+    size_t tag;
+    try {
+        file_.loadFromFile(tag);
+    } catch (const std::exception &) {
+        std::cerr << "Input trace ends with a truncated record tag" << std::endl;
+        return 0;
+    }
+    return tag;
+}
+
+void InputTrace::readDialogs() {
+    while (nextTag_ == TRACE_DIALOG) {
+        std::string path;
+        try {
+            file_.loadFromFile(path);
+        } catch (const std::exception &) {
+            std::cerr << "Input trace ends with a truncated dialog record" << std::endl;
+            nextTag_ = 0;
+            return;
+        }
+        dialogs_.push_back(path);
+        nextTag_ = readTag();
+    }
+}
@@ -0,0 +1,89 @@
+/// @file InputTrace.h
+/// @brief This file contains the definition of the InputTrace class.
+///
+/// Created by korikmat on 17.10.2026.
+
+#ifndef PROJECT_INPUTTRACE_H
+#define PROJECT_INPUTTRACE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+
+#include "../loaders/FileSaver.h"
+
+#define TRACE_MAGIC 0x3130656361727449ull ///< "Itrace01", read before any length-prefixed data.
+#define TRACE_VERSION 2
+#define TRACE_FRAME 1
+#define TRACE_DIALOG 2
+
+/// @class InputTrace
+/// @brief The InputTrace class records the input of every frame to a file and replays it later.
+/// @details Every frame record holds the delta time, mouse and scroll deltas and the keys that changed since
+/// the previous frame. Paths returned by the file dialogs are stored as separate records, so a replayed session
+/// loads the same models and scenes without any user interaction.
+class InputTrace {
+public:
+    /// @brief The mode of the trace (READ for replaying or WRITE for recording).
+    bool mode;
+
+    /// @brief The number of frames recorded or replayed so far.
+    size_t framesCount = 0;
+
+    /// @brief Constructs an InputTrace object and opens the trace file.
+    /// @param mode The mode of operation (READ or WRITE).
+    /// @param fileName The name of the trace file.
+    InputTrace(bool mode, std::string const &fileName);
+
+    /// @brief Gets the status of the trace file.
+    /// @return True if the trace file is open and valid, false otherwise.
+    bool getStatus();
+
+    /// @brief Records the current input state of Events.
+    /// @param deltaTime The delta time of the frame.
+    void record(float deltaTime);
+
+    /// @brief Replays the next frame into Events.
+    /// @param deltaTime The recorded delta time of the frame.
+    /// @return True if a frame was replayed, false at the end of the trace.
+    bool replay(float &deltaTime);
+
+    /// @brief Records a path returned by a file dialog.
+    /// @param path The selected path (empty if the dialog was cancelled).
+    void recordDialog(std::string path);
+
+    /// @brief Gets the next path recorded for a file dialog in the current frame.
+    /// @return The recorded path, empty if there is none.
+    std::string replayDialog();
+
+private:
+    /// @brief The file the trace is written to or read from.
+    FileSaver file_;
+
+    /// @brief Flag indicating whether the trace file has a valid header.
+    bool valid_ = false;
+
+    /// @brief The window width the trace was recorded with.
+    size_t width_ = 0;
+
+    /// @brief The window height the trace was recorded with.
+    size_t height_ = 0;
+
+    /// @brief The key states of the last recorded or replayed frame.
+    std::vector<wchar_t> keys_;
+
+    /// @brief The tag of the next record in the file, 0 at the end of the trace.
+    size_t nextTag_ = 0;
+
+    /// @brief Dialog paths recorded for the current frame.
+    std::deque<std::string> dialogs_;
+
+    /// @brief Reads the tag of the next record.
+    /// @return The tag, 0 at the end of the file or if the tag is cut off.
+    size_t readTag();
+
+    /// @brief Reads the dialog records following the current position, a cut off record ends the trace.
+    void readDialogs();
+};
+
+#endif //PROJECT_INPUTTRACE_H
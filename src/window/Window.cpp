@@ -2,19 +2,33 @@
 // Created by korma on 26.02.2024.
 //
 #include "Window.h"
+#include "Events.h"
+#include "InputTrace.h"
 
 #include <GL/glew.h>
 
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <cstdlib>
 
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+#endif
 
 
 GLFWwindow *Window::window;
 int Window::WIDTH;
 int Window::HEIGHT;
+bool Window::headless = false;
+#if defined(_WIN32) || defined(_WIN64)
 OPENFILENAME Window::ofn;
 char Window::szFile[512] = {0};
+#endif
 
 int Window::initialize(const char *title) {
     if (!glfwInit()) return -1;
@@ -51,7 +65,92 @@ int Window::initialize(const char *title) {
     return 0;
 }
 
+int Window::initializeHeadless(int width, int height) {
+    headless = true;
+    window = nullptr;
+    WIDTH = width;
+    HEIGHT = height;
+
+#if defined(__linux__)
+    // llvmpipe advertises GL 4.5 only, our shaders are #version 460
+    setenv("MESA_GL_VERSION_OVERRIDE", "4.6", 0);
+    setenv("MESA_GLSL_VERSION_OVERRIDE", "460", 0);
+
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    EGLint major, minor;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "Failed to initialize EGL display" << std::endl;
+        return -1;
+    }
+
+    const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_STENCIL_SIZE, 8,
+            EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configsCount = 0;
+    if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configsCount) || configsCount == 0) {
+        std::cerr << "Failed to choose EGL config" << std::endl;
+        Window::terminate();
+        return -1;
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, 6,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+    };
+    eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT) {
+        std::cerr << "Failed to create EGL context" << std::endl;
+        Window::terminate();
+        return -1;
+    }
+
+    // the pbuffer plays the role of the default framebuffer, so the renderer can keep drawing into framebuffer 0
+    const EGLint surfaceAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttribs);
+    if (eglSurface == EGL_NO_SURFACE || !eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        std::cerr << "Failed to create EGL pbuffer surface" << std::endl;
+        Window::destroy();
+        Window::terminate();
+        return -1;
+    }
+
+    glewExperimental = GL_TRUE;
+    GLenum glewStatus = glewInit();
+    // GLEW built for GLX complains about the missing X display, the GL entry points are loaded anyway
+    if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        Window::destroy();
+        Window::terminate();
+        return -1;
+    }
+    std::cout << "Headless context: " << glGetString(GL_VERSION) << " | " << glGetString(GL_RENDERER) << std::endl;
+    glViewport(0, 0, width, height);
+    return 0;
+#else
+    std::cerr << "Headless mode is supported only with EGL on Linux" << std::endl;
+    return -1;
+#endif
+}
+
 void Window::initializeFileSelectionDialog() {
+#if defined(_WIN32) || defined(_WIN64)
     ZeroMemory(&ofn, sizeof(ofn));
     ofn.lStructSize = sizeof(ofn);
     ofn.hwndOwner = NULL;
@@ -63,9 +162,20 @@ void Window::initializeFileSelectionDialog() {
     ofn.nMaxFileTitle = 0;
     ofn.lpstrInitialDir = NULL;
     ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
+#endif
 }
 
 void Window::terminate() {
+    if (headless) {
+#if defined(__linux__)
+        if (eglDisplay != EGL_NO_DISPLAY) {
+            eglTerminate(eglDisplay);
+            eglDisplay = EGL_NO_DISPLAY;
+            std::cout << "Terminated EGL." << std::endl;
+        }
+#endif
+        return;
+    }
     glfwTerminate();
     std::cout << "Terminated GLFW." << std::endl;
 }
@@ -77,33 +187,75 @@ void Window::getDisplayResolution(int *width, int *height) {
 }
 
 void Window::getWindowSize(int *width, int *height) {
+    if (headless) {
+        *width = WIDTH;
+        *height = HEIGHT;
+        return;
+    }
     glfwGetWindowSize(window, width, height);
 }
 
 bool Window::isWindowShouldClose() {
+    if (headless) {
+        return false;
+    }
     return glfwWindowShouldClose(window);
 }
 
 void Window::setWindowShouldClose(bool value) {
+    if (headless) {
+        return;
+    }
     glfwSetWindowShouldClose(window, value);
 }
 
 void Window::destroy() {
+    if (headless) {
+#if defined(__linux__)
+        if (eglDisplay != EGL_NO_DISPLAY) {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (eglSurface != EGL_NO_SURFACE) {
+                eglDestroySurface(eglDisplay, eglSurface);
+                eglSurface = EGL_NO_SURFACE;
+            }
+            if (eglContext != EGL_NO_CONTEXT) {
+                eglDestroyContext(eglDisplay, eglContext);
+                eglContext = EGL_NO_CONTEXT;
+            }
+        }
+#endif
+        return;
+    }
     glfwDestroyWindow(window);
 }
 
 void Window::swapBuffers() {
+    if (headless) {
+        // nothing is presented, just make sure the frame has been finished
+        glFinish();
+        return;
+    }
     glfwSwapBuffers(window);
 }
 
 void Window::getCursorPos(double *xpos, double *ypos) {
+    if (headless) {
+        *xpos = (double) WIDTH / 2;
+        *ypos = (double) HEIGHT / 2;
+        return;
+    }
     glfwGetCursorPos(window, xpos, ypos);
 }
 
 std::string Window::openFileSelectionDialog() {
+    if (Events::trace != nullptr && Events::trace->mode == READ) {
+        return Events::trace->replayDialog();
+    }
+    std::string szFileString;
+#if defined(_WIN32) || defined(_WIN64)
     ofn.lpstrFilter = "All Files\0*.*\0OBJ Files\0*.OBJ\0FBX Files\0*.FBX\0BIN Files\0*.BIN\0";
     if (GetOpenFileName(&ofn) == TRUE) {
-        std::string szFileString(szFile);
+        szFileString = szFile;
         std::string currentPath = std::filesystem::current_path().string();
 
         size_t pos = szFileString.find(currentPath);
@@ -113,15 +265,23 @@ std::string Window::openFileSelectionDialog() {
 
         }
         std::cout << "File selected: " << szFileString << std::endl;
-        return szFileString;
     }
-    return "";
+#endif
+    if (Events::trace != nullptr) {
+        Events::trace->recordDialog(szFileString);
+    }
+    return szFileString;
 }
 
 std::string Window::openFileSaverDialog() {
+    if (Events::trace != nullptr && Events::trace->mode == READ) {
+        return Events::trace->replayDialog();
+    }
+    std::string szFileString;
+#if defined(_WIN32) || defined(_WIN64)
     ofn.lpstrFilter = "All Files\0*.*\0OBJ Files\0*.OBJ\0FBX Files\0*.FBX\0BIN Files\0*.BIN\0";
     if (GetSaveFileName(&ofn) == TRUE) {
-        std::string szFileString(szFile);
+        szFileString = szFile;
         std::string currentPath = std::filesystem::current_path().string();
 
         size_t pos = szFileString.find(currentPath);
@@ -131,7 +291,10 @@ std::string Window::openFileSaverDialog() {
 
         }
         std::cout << "File selected: " << szFileString << std::endl;
-        return szFileString;
     }
-    return "";
+#endif
+    if (Events::trace != nullptr) {
+        Events::trace->recordDialog(szFileString);
+    }
+    return szFileString;
 }
\ No newline at end of file
@@ -29,6 +29,9 @@ public:
     /// @brief Pointer to the GLFW window object.
     static GLFWwindow *window;
 
+    /// @brief Flag indicating whether the engine runs offscreen without a window and display.
+    static bool headless;
+
     #if defined(_WIN32) || defined(_WIN64)
     /// @brief Open file name structure for file dialogs (Windows only).
     static OPENFILENAME ofn;
@@ -42,6 +45,13 @@ public:
     /// @return An integer representing the success or failure of the initialization.
     static int initialize(const char *title);
 
+    /// @brief Initializes an offscreen OpenGL context without a window (surfaceless EGL, e.g. Mesa llvmpipe).
+    /// @details GLFW is not initialized in this mode, so no input events are received.
+    /// @param width The width of the offscreen framebuffer.
+    /// @param height The height of the offscreen framebuffer.
+    /// @return An integer representing the success or failure of the initialization.
+    static int initializeHeadless(int width, int height);
+
     /// @brief Terminates the window and cleans up resources.
     static void terminate();
 